@@ -118,6 +118,72 @@ void BST<N>::inOrder(BNode<N> *curr, int leftWidth) const
    }
 }
 
+/**
+ * print(int, int)
+ * Print the nodes of the tree, formatting ranges of nodes on nThreads
+ * threads. Same output as print(width).
+ * Calls: printParallel
+ * @param width used to align right text margin.
+ * @param nThreads number of threads used to format the output
+ */
+template <class N>
+void BST<N>::print(int width, int nThreads) const
+{
+   if (nThreads <= 1)
+   {
+      print(width);
+      return;
+   }
+
+   std::vector<N*> items;
+   forEach([&items](N& item) { items.push_back(&item); });
+   printParallel(items, width, nThreads, std::cout);
+}
+
+/**
+ * forEach
+ * Do an inorder traverse, and call visit on each item.
+ * @param curr node to begin traversal at.
+ * @param visit callable taking N&
+ */
+template <class N>
+template <class F>
+void BST<N>::forEach(BNode<N> *curr, F& visit) const
+{
+   if (curr != nullptr)
+   {
+      forEach(curr->getLeftNodePtr(), visit);
+      visit(*(curr->getItem()));
+      forEach(curr->getRightNodePtr(), visit);
+   }
+}
+
+/**
+ * forEachInRange
+ * Do an inorder traverse of the items in a range, and call visit on
+ * each one. The left subtree can only hold items in the range if this
+ * item is not before it, and the right subtree only if it is not after.
+ * @param curr node to begin traversal at.
+ * @param compare callable taking const N&, returning < 0 if the item
+ *   is before the range, 0 if it is in the range, > 0 if after it
+ * @param visit callable taking N&
+ */
+template <class N>
+template <class C, class F>
+void BST<N>::forEachInRange(BNode<N> *curr, C& compare, F& visit) const
+{
+   if (curr == nullptr)
+      return;
+
+   int cmp = compare(*(curr->getItem()));
+   if (cmp >= 0)
+      forEachInRange(curr->getLeftNodePtr(), compare, visit);
+   if (cmp == 0)
+      visit(*(curr->getItem()));
+   if (cmp <= 0)
+      forEachInRange(curr->getRightNodePtr(), compare, visit);
+}
+
 /**
  * clear
  * Delete the nodes in the tree using a post-order traversal.
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "BNode.h"
+#include "ParallelPrint.h"
 
 /**
  * class BST
@@ -66,6 +67,36 @@ public:
     */
    void print(int width) const { inOrder(this->root, width); }
 
+   /**
+    * print(int, int)
+    * Print the nodes of the tree, formatting ranges of nodes on nThreads
+    * threads. Same output as print(width).
+    * Calls: printParallel
+    * @param width used to align right text margin.
+    * @param nThreads number of threads used to format the output
+    */
+   void print(int width, int nThreads) const;
+
+   /**
+    * forEach
+    * Call visit on every item in the tree, in order.
+    * @param visit callable taking N&
+    */
+   template <class F>
+   void forEach(F visit) const { forEach(this->root, visit); }
+
+   /**
+    * forEachInRange
+    * Call visit on every item in a range of the tree, in order. Subtrees
+    * outside the range are skipped.
+    * @param compare callable taking const N&, returning < 0 if the item
+    *   is before the range, 0 if it is in the range, > 0 if after it
+    * @param visit callable taking N&
+    */
+   template <class C, class F>
+   void forEachInRange(C compare, F visit) const {
+                                 forEachInRange(this->root, compare, visit); }
+
 private:
    BNode<N>* root = nullptr; // root node of tree
 
@@ -101,6 +132,27 @@ private:
     */
    void inOrder(BNode<N>* curr, int width) const;
 
+   /**
+    * forEach
+    * Do an inorder traverse, and call visit on each item.
+    * @param curr node to begin traversal at.
+    * @param visit callable taking N&
+    */
+   template <class F>
+   void forEach(BNode<N>* curr, F& visit) const;
+
+   /**
+    * forEachInRange
+    * Do an inorder traverse of the items in a range, and call visit on
+    * each one.
+    * @param curr node to begin traversal at.
+    * @param compare callable taking const N&, returning < 0 if the item
+    *   is before the range, 0 if it is in the range, > 0 if after it
+    * @param visit callable taking N&
+    */
+   template <class C, class F>
+   void forEachInRange(BNode<N>* curr, C& compare, F& visit) const;
+
    /**
     * clear
     * Delete the nodes in the tree using a post-order traversal.
@@ -0,0 +1,317 @@
+/**
+ * BTree.cpp
+ * Definitions for templated class BTree.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include "BTree.h"
+
+/**
+ * prefixOf
+ * Get the first 8 bytes of a key as a big endian integer, padded with
+ * zeros, so comparing prefixes orders keys as comparing strings does,
+ * except that equal prefixes may still be different keys.
+ * @param key key string
+ * @return prefix of key
+ */
+template <class N>
+uint64_t BTree<N>::prefixOf(const std::string& key)
+{
+   uint64_t prefix = 0;
+   for (size_t i = 0; i < 8; i++)
+   {
+      prefix <<= 8;
+      if (i < key.length())
+         prefix |= static_cast<unsigned char>(key[i]);
+   }
+   return prefix;
+}
+
+/**
+ * compareAt
+ * Compare a key with key i of a node.
+ * @param node node to compare with
+ * @param i index of the key in the node
+ * @param prefix prefixOf(key)
+ * @param key key string
+ * @return < 0 if key is less, 0 if equal, > 0 if greater
+ */
+template <class N>
+int BTree<N>::compareAt(const Node& node, int i, uint64_t prefix,
+                        const std::string& key) const
+{
+   if (prefix != node.prefix[i])
+      return (prefix < node.prefix[i]) ? -1 : 1;
+   return key.compare(keys[node.item[i]]);
+}
+
+/**
+ * lowerBound
+ * Find the first key of a node that is not less than key.
+ * A linear scan: the prefixes of a node fit in two cache lines.
+ * @param node node to search
+ * @param prefix prefixOf(key)
+ * @param key key string
+ * @param equal set to true if that key equals key
+ * @return index of the key, or node.count if every key is less
+ */
+template <class N>
+int BTree<N>::lowerBound(const Node& node, uint64_t prefix,
+                         const std::string& key, bool& equal) const
+{
+   for (int i = 0; i < node.count; i++)
+   {
+      if (prefix > node.prefix[i])
+         continue;
+      int cmp = compareAt(node, i, prefix, key);
+      if (cmp <= 0)
+      {
+         equal = (cmp == 0);
+         return i;
+      }
+   }
+   equal = false;
+   return node.count;
+}
+
+/**
+ * find
+ * Find the item with the same key as item in the tree.
+ * @param item item of type N to find
+ * @return pointer to the item of type N in the tree.
+ *   If not found, returns nullptr.
+ */
+template <class N>
+N* BTree<N>::find(const N& item) const
+{
+   if (nodes.empty())
+      return nullptr;
+
+   const std::string& key = keyOf(item);
+   uint64_t prefix = prefixOf(key);
+   uint32_t curr = 0;
+   while (true)
+   {
+      const Node& node = nodes[curr];
+      bool equal;
+      int i = lowerBound(node, prefix, key, equal);
+      if (equal)
+         return &items[node.item[i]];
+      if (node.leaf)
+         return nullptr;
+      curr = node.child[i];
+   }
+}
+
+/**
+ * insert
+ * Insert item of type N into the tree.
+ * Full nodes are split on the way down, so there is always room in the
+ * parent for the middle key of a split.
+ * Item must not already exist in the tree (exception thrown). A duplicate
+ * is found on the way down, so nodes split before it was found stay split;
+ * the tree is still valid and holds the same keys.
+ * @param item of type N to insert.
+ * return true if item was inserted, otherwise false.
+ */
+template <class N>
+bool BTree<N>::insert(const N& item)
+{
+   if (keys.size() == UINT32_MAX)
+      throw "BTree is full.";
+
+   const std::string& key = keyOf(item);
+   uint64_t prefix = prefixOf(key);
+
+   if (nodes.empty())
+   {
+      Node root;
+      root.count = 0;
+      root.leaf = true;
+      nodes.push_back(root);
+   }
+   else if (nodes[0].count == MAX_KEYS)
+   {
+      // the root stays node 0: move it, and make node 0 its new parent
+      Node oldRoot = nodes[0];
+      nodes.push_back(oldRoot);
+      Node& root = nodes[0];
+      root.count = 0;
+      root.leaf = false;
+      root.child[0] = nodes.size() - 1;
+      splitChild(0, 0);
+   }
+
+   uint32_t curr = 0;
+   while (!nodes[curr].leaf)
+   {
+      bool equal;
+      int i = lowerBound(nodes[curr], prefix, key, equal);
+      if (equal)
+         throw "Duplicate nodes not permitted in BTree.";
+      if (nodes[nodes[curr].child[i]].count == MAX_KEYS)
+      {
+         splitChild(curr, i);
+         // the middle key moved up to i; go right of it if key is greater
+         int order = compareAt(nodes[curr], i, prefix, key);
+         if (order == 0)
+            throw "Duplicate nodes not permitted in BTree.";
+         if (order > 0)
+            i++;
+      }
+      curr = nodes[curr].child[i];
+   }
+
+   Node& leaf = nodes[curr];
+   bool equal;
+   int i = lowerBound(leaf, prefix, key, equal);
+   if (equal)
+      throw "Duplicate nodes not permitted in BTree.";
+   for (int j = leaf.count; j > i; j--)
+   {
+      leaf.prefix[j] = leaf.prefix[j - 1];
+      leaf.item[j] = leaf.item[j - 1];
+   }
+   leaf.prefix[i] = prefix;
+   leaf.item[i] = keys.size();
+   leaf.count++;
+
+   keys.push_back(key);
+   items.push_back(item);
+   return true;
+}
+
+/**
+ * splitChild
+ * Split the full child i of a node in two, moving its middle key up
+ * into the node.
+ * @param parent index of a node that is not full
+ * @param i index of the full child in the parent
+ */
+template <class N>
+void BTree<N>::splitChild(uint32_t parent, int i)
+{
+   // push_back may move the nodes, so take references after it
+   nodes.push_back(Node());
+   uint32_t rightIndex = nodes.size() - 1;
+   Node& left = nodes[nodes[parent].child[i]];
+   Node& right = nodes[rightIndex];
+   Node& node = nodes[parent];
+
+   // the upper MIN_DEGREE - 1 keys (and their children) move right
+   right.leaf = left.leaf;
+   right.count = MIN_DEGREE - 1;
+   for (int j = 0; j < MIN_DEGREE - 1; j++)
+   {
+      right.prefix[j] = left.prefix[j + MIN_DEGREE];
+      right.item[j] = left.item[j + MIN_DEGREE];
+   }
+   if (!left.leaf)
+   {
+      for (int j = 0; j < MIN_DEGREE; j++)
+         right.child[j] = left.child[j + MIN_DEGREE];
+   }
+   left.count = MIN_DEGREE - 1;
+
+   // make room in the parent for the middle key and the new child
+   for (int j = node.count; j > i; j--)
+   {
+      node.prefix[j] = node.prefix[j - 1];
+      node.item[j] = node.item[j - 1];
+      node.child[j + 1] = node.child[j];
+   }
+   node.prefix[i] = left.prefix[MIN_DEGREE - 1];
+   node.item[i] = left.item[MIN_DEGREE - 1];
+   node.child[i + 1] = rightIndex;
+   node.count++;
+}
+
+/**
+ * print(int)
+ * Print the nodes of the tree, in order.
+ * @param width used to align right text margin.
+ */
+template <class N>
+void BTree<N>::print(int width) const
+{
+   forEach([width](N& item) {
+      std::cout << std::setw(width) << std::right;
+      std::cout << item << std::endl;
+   });
+}
+
+/**
+ * print(int, int)
+ * Print the nodes of the tree, formatting ranges of nodes on nThreads
+ * threads. Same output as print(width).
+ * Calls: printParallel
+ * @param width used to align right text margin.
+ * @param nThreads number of threads used to format the output
+ */
+template <class N>
+void BTree<N>::print(int width, int nThreads) const
+{
+   if (nThreads <= 1)
+   {
+      print(width);
+      return;
+   }
+
+   std::vector<N*> ordered;
+   forEach([&ordered](N& item) { ordered.push_back(&item); });
+   printParallel(ordered, width, nThreads, std::cout);
+}
+
+/**
+ * forEach
+ * Do an inorder traversal of a subtree, and call visit on each item.
+ * @param curr index of the node to begin traversal at.
+ * @param visit callable taking N&
+ */
+template <class N>
+template <class F>
+void BTree<N>::forEach(uint32_t curr, F& visit) const
+{
+   const Node& node = nodes[curr];
+   for (int i = 0; i < node.count; i++)
+   {
+      if (!node.leaf)
+         forEach(node.child[i], visit);
+      visit(items[node.item[i]]);
+   }
+   if (!node.leaf)
+      forEach(node.child[node.count], visit);
+}
+
+/**
+ * forEachInRange
+ * Do an inorder traversal of the items of a subtree in a range, and
+ * call visit on each one. Child i can only hold items in the range if
+ * key i is not before it; the traversal stops at the first key after it.
+ * @param curr index of the node to begin traversal at.
+ * @param compare callable taking const N&, returning < 0 if the item
+ *   is before the range, 0 if it is in the range, > 0 if after it
+ * @param visit callable taking N&
+ * @return false if an item after the range was found, otherwise true
+ */
+template <class N>
+template <class C, class F>
+bool BTree<N>::forEachInRange(uint32_t curr, C& compare, F& visit) const
+{
+   const Node& node = nodes[curr];
+   for (int i = 0; i < node.count; i++)
+   {
+      int cmp = compare(items[node.item[i]]);
+      if (cmp >= 0 && !node.leaf &&
+          !forEachInRange(node.child[i], compare, visit))
+         return false;
+      if (cmp > 0)
+         return false;
+      if (cmp == 0)
+         visit(items[node.item[i]]);
+   }
+   if (!node.leaf)
+      return forEachInRange(node.child[node.count], compare, visit);
+   return true;
+}
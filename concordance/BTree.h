@@ -0,0 +1,186 @@
+/**
+ * BTree.h
+ * Declarations for templated class BTree<>
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "CompactBST.h"
+#include "ParallelPrint.h"
+
+/**
+ * class BTree
+ * Class template for a B-tree with the same interface as BST<N>.
+ * Each node holds up to MAX_KEYS keys, so a search visits about
+ * log16(n) nodes instead of the log2(n) of a binary tree. A node keeps
+ * the first 8 bytes of each of its keys as an integer prefix, so most
+ * comparisons in a node read only the node itself; the full key is
+ * compared only when the prefixes are equal.
+ * Nodes are kept in one vector and linked by 32-bit indices. The keys
+ * and items are kept apart, as in CompactBST, so pointers to the items
+ * stay valid as the tree grows.
+ * Items are ordered by keyOf(item), which must be declared for N.
+ * Duplicates not allowed (throws exception).
+ * Use find() first to ensure item in node not already in the tree.
+ */
+template <class N>
+class BTree
+{
+public:
+   /**
+    * find
+    * Find the item with the same key as item in the tree.
+    * @param item item of type N to find
+    * @return pointer to the item of type N in the tree.
+    *   If not found, returns nullptr.
+    */
+   N* find(const N& item) const;
+
+   /**
+    * insert
+    * Insert item of type N into the tree.
+    * Item must not already exist in the tree (exception thrown).
+    * @param item of type N to insert.
+    * return true if item was inserted, otherwise false.
+    */
+   bool insert(const N& item);
+
+   /**
+    * print(int)
+    * Print the nodes of the tree, in order.
+    * @param width used to align right text margin. Used in
+    *   cout << setw(width) << right <<
+    * output sequence.
+    */
+   void print(int width) const;
+
+   /**
+    * print(int, int)
+    * Print the nodes of the tree, formatting ranges of nodes on nThreads
+    * threads. Same output as print(width).
+    * Calls: printParallel
+    * @param width used to align right text margin.
+    * @param nThreads number of threads used to format the output
+    */
+   void print(int width, int nThreads) const;
+
+   /**
+    * forEach
+    * Call visit on every item in the tree, in order.
+    * @param visit callable taking N&
+    */
+   template <class F>
+   void forEach(F visit) const { if (!nodes.empty()) forEach(0, visit); }
+
+   /**
+    * forEachInRange
+    * Call visit on every item in a range of the tree, in order. Subtrees
+    * outside the range are skipped.
+    * @param compare callable taking const N&, returning < 0 if the item
+    *   is before the range, 0 if it is in the range, > 0 if after it
+    * @param visit callable taking N&
+    */
+   template <class C, class F>
+   void forEachInRange(C compare, F visit) const {
+                  if (!nodes.empty()) forEachInRange(0, compare, visit); }
+
+   /**
+    * size
+    * @return number of items in the tree
+    */
+   size_t size() const { return this->keys.size(); }
+
+private:
+   static const int MIN_DEGREE = 8; // a node other than the root has
+                                    // MIN_DEGREE - 1 .. MAX_KEYS keys
+   static const int MAX_KEYS = 2 * MIN_DEGREE - 1;
+
+   /**
+    * B-tree node. The keys of the node are keys[item[0 .. count - 1]],
+    * in order. Child i holds the keys between key i - 1 and key i.
+    */
+   struct Node
+   {
+      uint64_t prefix[MAX_KEYS]; // first 8 bytes of each key (see prefixOf)
+      uint32_t item[MAX_KEYS]; // index of each key in keys and items
+      uint32_t child[MAX_KEYS + 1]; // child node indices, if not a leaf
+      int count; // number of keys
+      bool leaf; // true if the node has no children
+   };
+
+   std::vector<Node> nodes; // node 0 is the root
+   std::vector<std::string> keys; // keyOf(item), by item index
+   // items, by item index; mutable, since find returns N* (as BST does)
+   mutable std::deque<N> items;
+
+   /**
+    * prefixOf
+    * Get the first 8 bytes of a key as a big endian integer, padded with
+    * zeros, so comparing prefixes orders keys as comparing strings does,
+    * except that equal prefixes may still be different keys.
+    * @param key key string
+    * @return prefix of key
+    */
+   static uint64_t prefixOf(const std::string& key);
+
+   /**
+    * compareAt
+    * Compare a key with key i of a node.
+    * @param node node to compare with
+    * @param i index of the key in the node
+    * @param prefix prefixOf(key)
+    * @param key key string
+    * @return < 0 if key is less, 0 if equal, > 0 if greater
+    */
+   int compareAt(const Node& node, int i, uint64_t prefix,
+                 const std::string& key) const;
+
+   /**
+    * lowerBound
+    * Find the first key of a node that is not less than key.
+    * @param node node to search
+    * @param prefix prefixOf(key)
+    * @param key key string
+    * @param equal set to true if that key equals key
+    * @return index of the key, or node.count if every key is less
+    */
+   int lowerBound(const Node& node, uint64_t prefix, const std::string& key,
+                  bool& equal) const;
+
+   /**
+    * splitChild
+    * Split the full child i of a node in two, moving its middle key up
+    * into the node.
+    * @param parent index of a node that is not full
+    * @param i index of the full child in the parent
+    */
+   void splitChild(uint32_t parent, int i);
+
+   /**
+    * forEach
+    * Do an inorder traversal of a subtree, and call visit on each item.
+    * @param curr index of the node to begin traversal at.
+    * @param visit callable taking N&
+    */
+   template <class F>
+   void forEach(uint32_t curr, F& visit) const;
+
+   /**
+    * forEachInRange
+    * Do an inorder traversal of the items of a subtree in a range, and
+    * call visit on each one.
+    * @param curr index of the node to begin traversal at.
+    * @param compare callable taking const N&, returning < 0 if the item
+    *   is before the range, 0 if it is in the range, > 0 if after it
+    * @param visit callable taking N&
+    * @return false if an item after the range was found, otherwise true
+    */
+   template <class C, class F>
+   bool forEachInRange(uint32_t curr, C& compare, F& visit) const;
+};
+
+#include "BTree.cpp"
@@ -0,0 +1,78 @@
+/**
+ * BloomFilter.cpp
+ * Definitions for class BloomFilter.
+ */
+
+#include "BloomFilter.h"
+
+/**
+ * init
+ * Size the filter for a number of words, and clear it.
+ * The bit array is at least one 64 bit word.
+ * @param words number of words that will be added
+ */
+void BloomFilter::init(size_t words)
+{
+   size_t nWords = (words * BITS_PER_WORD + 63) / 64;
+   if (nWords == 0)
+      nWords = 1;
+   bits.assign(nWords, 0);
+   numBits = nWords * 64;
+}
+
+/**
+ * add
+ * Add a word to the filter.
+ * Probe i is bit (h1 + i * h2) mod numBits, where h1 and h2 are the low
+ * and high halves of the hash.
+ * @param hash hash of the word, from hashWord()
+ */
+void BloomFilter::add(uint64_t hash)
+{
+   uint64_t h1 = hash & 0xffffffff;
+   uint64_t h2 = (hash >> 32) | 1;
+   for (int i = 0; i < PROBES; i++)
+   {
+      uint64_t bit = (h1 + i * h2) % numBits;
+      bits[bit / 64] |= (uint64_t) 1 << (bit % 64);
+   }
+}
+
+/**
+ * mayContain
+ * Test if a word may have been added.
+ * Stops at the first probe that finds a clear bit.
+ * @param hash hash of the word, from hashWord()
+ * @return false if the word was certainly not added
+ */
+bool BloomFilter::mayContain(uint64_t hash) const
+{
+   uint64_t h1 = hash & 0xffffffff;
+   uint64_t h2 = (hash >> 32) | 1;
+   for (int i = 0; i < PROBES; i++)
+   {
+      uint64_t bit = (h1 + i * h2) % numBits;
+      if ((bits[bit / 64] & ((uint64_t) 1 << (bit % 64))) == 0)
+         return false;
+   }
+   return true;
+}
+
+/**
+ * hashWord
+ * @return FNV-1a hash of a word, with extra mixing of the high bits
+ */
+uint64_t BloomFilter::hashWord(const std::string& word)
+{
+   uint64_t h = 14695981039346656037ULL;
+   for (size_t i = 0; i < word.length(); i++)
+   {
+      h ^= (unsigned char) word[i];
+      h *= 1099511628211ULL;
+   }
+   // FNV leaves the high bits weak for short words
+   h ^= h >> 29;
+   h *= 0xbf58476d1ce4e5b9ULL;
+   h ^= h >> 32;
+   return h;
+}
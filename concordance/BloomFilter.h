@@ -0,0 +1,64 @@
+/**
+ * BloomFilter.h
+ * Declarations for class BloomFilter.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * class BloomFilter
+ * A bit array that answers "possibly present" or "definitely absent"
+ * for a set of words. Each word sets PROBES bits, chosen by double
+ * hashing from one 64 bit hash of the word. With BITS_PER_WORD bits for
+ * each word added, under 1% of absent words are reported as possibly
+ * present.
+ */
+class BloomFilter
+{
+   static const int BITS_PER_WORD = 10;
+   static const int PROBES = 7;
+
+public:
+   /**
+    * init
+    * Size the filter for a number of words, and clear it.
+    * @param words number of words that will be added
+    */
+   void init(size_t words);
+
+   /**
+    * add
+    * Add a word to the filter.
+    * @param hash hash of the word, from hashWord()
+    */
+   void add(uint64_t hash);
+
+   /**
+    * mayContain
+    * Test if a word may have been added.
+    * @param hash hash of the word, from hashWord()
+    * @return false if the word was certainly not added
+    */
+   bool mayContain(uint64_t hash) const;
+
+   /**
+    * bytes
+    * @return size of the bit array in bytes
+    */
+   size_t bytes() const { return bits.size() * sizeof(uint64_t); }
+
+   /**
+    * hashWord
+    * @return FNV-1a hash of a word, with extra mixing of the high bits
+    */
+   static uint64_t hashWord(const std::string& word);
+
+private:
+   std::vector<uint64_t> bits; // the bit array
+   uint64_t numBits = 0; // number of bits in the array
+};
@@ -0,0 +1,82 @@
+/**
+ * CBNode.h
+ *
+ * Header file for class CBNode.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+/**
+ * class CBNode
+ * Class template for the individual nodes of a concurrent binary search
+ * tree of type N.
+ * The child pointers are atomic so that new nodes can be linked into the
+ * tree with a single compare-and-swap, without locking the parent.
+ * Each node has its own mutex, used to serialize updates to the item.
+ */
+template <class N>
+class CBNode
+{
+ private:
+   N item; // data item of type N for node
+   std::atomic<CBNode*> left; // left child pointer
+   std::atomic<CBNode*> right; // right child pointer
+   std::mutex lock; // guards updates to item
+
+ public:
+
+   /**
+    * Constructor.
+    * Creates a new node with an item of type N.
+    * @param newItem of type N
+    */
+   CBNode(const N& newItem) : item(newItem), left(nullptr), right(nullptr) {}
+
+   /**
+    * getLeftLink
+    * Get the atomic left child pointer.
+    * @returns reference to the left child pointer
+    */
+   std::atomic<CBNode*>& getLeftLink() { return this->left; }
+
+   /**
+    * getRightLink
+    * Get the atomic right child pointer.
+    * @returns reference to the right child pointer
+    */
+   std::atomic<CBNode*>& getRightLink() { return this->right; }
+
+   /**
+    * getLeftNodePtr
+    * Get the pointer to the left child node.
+    * @returns pointer to CBNode
+    */
+   CBNode* getLeftNodePtr() const
+                        { return this->left.load(std::memory_order_acquire); }
+
+   /**
+    * getRightNodePtr
+    * Get the pointer to the right child node.
+    * @returns pointer to CBNode
+    */
+   CBNode* getRightNodePtr() const
+                        { return this->right.load(std::memory_order_acquire); }
+
+   /**
+    * getLock
+    * Get the mutex that guards updates to the item.
+    * @returns reference to the node mutex
+    */
+   std::mutex& getLock() { return this->lock; }
+
+   /**
+    * getItem
+    * Get a pointer to the item of type N for the node.
+    * @return pointer to item of type N
+    */
+   N* getItem() { return &item; }
+
+};
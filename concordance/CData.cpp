@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <random>
 #include "CData.h"
 #include "DataIn.h"
 #include "BNode.h"
@@ -15,7 +16,9 @@
 /**
  * initialize the static variable
  */
-int CData::width = 0;
+std::atomic<int> CData::width(0);
+const TokenStore* CData::tokens = nullptr;
+size_t CData::sampleSize = 0;
 
 /**
  * constructor
@@ -25,9 +28,12 @@ int CData::width = 0;
 CData::CData(DataIn& din)
 {
    this->keyWord = din.keyWord;
-   this->context.addTail(din.before, din.after);
-   if (CData::width < din.width)
-      CData::width = din.width;
+   this->count = 1;
+   if (din.position >= 0)
+      this->positions.add(din.position);
+   else
+      this->context.addTail(din.before, din.after);
+   updateWidth(din.width);
 }
 
 /**
@@ -38,6 +44,8 @@ CData::CData(DataIn& din)
 CData::CData(const CData& src)
 {
    this->keyWord = src.keyWord;
+   this->count = src.count;
+   this->positions = src.positions;
    this->context.setHeadPtr(nullptr);
    this->context.setTailPtr(nullptr);
 
@@ -56,14 +64,44 @@ CData::CData(const CData& src)
  * and after context strings.
  * Update CData::width if length of before context string is larger.
  * Used when the keyWord already exists in the BST.
+ * If CData::sampleSize contexts are already kept, the new context
+ * replaces a random one with probability sampleSize / count.
  * @param din struct containing the before and after context strings for the
  * new linked list node.
  */
 void CData::update(const DataIn& din)
 {
-   context.addTail(din.before, din.after);
-   if (CData::width < din.width)
-      CData::width = din.width;
+   count++;
+   if (din.position >= 0)
+      positions.add(din.position);
+   else if (sampleSize == 0 || count <= sampleSize)
+      context.addTail(din.before, din.after);
+   else
+   {
+      // reservoir sampling; one generator per thread, since updates to
+      // different key words may run at the same time
+      thread_local std::mt19937_64 rng(std::random_device{}());
+      size_t index = std::uniform_int_distribution<size_t>(0, count - 1)(rng);
+      if (index >= sampleSize)
+         return;
+      context.replace(index, din.before, din.after);
+   }
+   updateWidth(din.width);
+}
+
+/**
+ * updateWidth
+ * Raise CData::width to newWidth if it is larger.
+ * Safe to call from several threads.
+ * @param newWidth length of a before context string
+ */
+void CData::updateWidth(int newWidth)
+{
+   int curr = CData::width.load();
+   // on failure curr is reloaded, so retry only while still smaller
+   while (curr < newWidth &&
+          !CData::width.compare_exchange_weak(curr, newWidth))
+      ;
 }
 
 /**
@@ -89,35 +127,106 @@ void CData::print()
 
 }
 
+/**
+ * getContextBytes
+ * Get the number of bytes used to store the contexts: the linked list
+ * nodes and their strings, or the compressed posting list.
+ * @return bytes used for the contexts
+ */
+size_t CData::getContextBytes() const
+{
+   size_t bytes = positions.bytes();
+   for (LNode* curr = context.getHeadPtr(); curr != nullptr; curr = curr->next)
+      bytes += lnodeBytes(curr->before, curr->after);
+   return bytes;
+}
+
+/**
+ * getListBytes
+ * Get the number of bytes the contexts use, or would use, as LNode
+ * strings in a CList.
+ * @return bytes for the contexts as a linked list
+ */
+size_t CData::getListBytes() const
+{
+   size_t bytes = 0;
+   for (LNode* curr = context.getHeadPtr(); curr != nullptr; curr = curr->next)
+      bytes += lnodeBytes(curr->before, curr->after);
+   positions.forEach([&bytes](uint32_t pos) {
+      bytes += lnodeBytes(tokens->getBefore(pos), tokens->getAfter(pos));
+   });
+   return bytes;
+}
+
+/**
+ * lnodeBytes
+ * Get the bytes used by an LNode holding a pair of context strings.
+ * Strings longer than 15 chars keep their characters (plus a null)
+ * outside the string object.
+ * @param before before context string
+ * @param after after context string
+ * @return size of the node plus characters stored outside the strings
+ */
+size_t CData::lnodeBytes(const std::string& before, const std::string& after)
+{
+   size_t bytes = sizeof(LNode);
+   if (before.length() > 15)
+      bytes += before.length() + 1;
+   if (after.length() > 15)
+      bytes += after.length() + 1;
+   return bytes;
+}
+
 /**
  * operator <<
  * Overload the outstream operator for this class.
- * Loop through all the nodes in the linked list.
- * Use reset() and advanceCounter() methods of linked list to
- * advance a pointer to the linked list node to print.
+ * Walk the nodes of the linked list with a local pointer, so printing
+ * does not change the CData, and several threads may print at once.
+ * With a posting list, rebuild the context strings of each position
+ * from CData::tokens.
+ * If only a sample of the contexts is kept, add a line with the
+ * number of occurrences.
  * Use CData::width to format the before context string.
  * @param os the outstream (ostream) object.
  * @param data CData object that contains the output data
  * @return reference to ostream
  */
-std::ostream& operator<<(std::ostream &os, CData &data)
+std::ostream& operator<<(std::ostream &os, const CData &data)
 {
    bool multiple = false;
    int leftWidth = CData::width;
+
+   if (!data.positions.empty())
+   {
+      data.positions.forEach([&](uint32_t pos) {
+         if (multiple)
+         {
+            os << std::endl;
+            os << std::setw(leftWidth) << std::right;
+         }
+         os << CData::tokens->getBefore(pos) << CData::tokens->getAfter(pos);
+         multiple = true;
+      });
+      return os;
+   }
    
-   data.context.reset();
-   do
+   for (LNode* curr = data.context.getHeadPtr(); curr != nullptr;
+        curr = curr->next)
    {
       if (multiple)
       {
          os << std::endl;
          os << std::setw(leftWidth) << std::right;
       }
-      os << data.context.getBefore() << data.context.getAfter();
+      os << curr->before << curr->after;
       multiple = true;
+   }
 
-   } while (data.context.advanceCounter());
-   data.context.reset();
-
+   if (CData::sampleSize > 0 && data.count > CData::sampleSize)
+   {
+      os << std::endl << std::setw(leftWidth) << "";
+      os << "[" << data.count << " occurrences, ";
+      os << CData::sampleSize << " shown]";
+   }
    return os;
 }
\ No newline at end of file
@@ -8,10 +8,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <ostream>
 #include <string>
 #include "CList.h"
 #include "DataIn.h"
+#include "PostingList.h"
+#include "TokenStore.h"
 
 /**
  * class CData
@@ -22,7 +25,17 @@ class CData
  public:
    // length of (eventually) longest before context string
    // updated each time CData is created or updated
-   static int width;
+   // atomic, since CData objects may be created on several threads
+   static std::atomic<int> width;
+
+   // corpus words for rebuilding context strings from token positions
+   // set when the concordance is built with compressed posting lists
+   static const TokenStore* tokens;
+
+   // most context strings kept for each key word, or 0 to keep them all
+   // with a limit, the contexts kept are a uniform random sample (a
+   // reservoir) of all the occurrences, and the count stays exact
+   static size_t sampleSize;
    
    /**
     * constructor
@@ -43,7 +56,7 @@ class CData
     * Get the keyWord data element.
     * @return string that contains the keyWord
     */
-   const std::string getKeyWord() const { return this->keyWord; }
+   const std::string& getKeyWord() const { return this->keyWord; }
 
    /**
     * update
@@ -51,6 +64,8 @@ class CData
     * and after context strings.
     * Update CData::width if length of before context string is larger.
     * Used when the keyWord already exists in the BST.
+    * If CData::sampleSize contexts are already kept, the new context
+    * replaces a random one with probability sampleSize / count.
     * @param din struct containing the before and after context strings for the
     * new linked list node.
     */
@@ -67,6 +82,29 @@ class CData
     */
    void print();
 
+   /**
+    * getCount
+    * Get the number of occurrences of the key word.
+    * @return number of occurrences, including any not kept in a sample
+    */
+   size_t getCount() const { return this->count; }
+
+   /**
+    * getContextBytes
+    * Get the number of bytes used to store the contexts: the linked list
+    * nodes and their strings, or the compressed posting list.
+    * @return bytes used for the contexts
+    */
+   size_t getContextBytes() const;
+
+   /**
+    * getListBytes
+    * Get the number of bytes the contexts use, or would use, as LNode
+    * strings in a CList.
+    * @return bytes for the contexts as a linked list
+    */
+   size_t getListBytes() const;
+
    /**
     * operator >
     * Implement the greater than comparison operator.
@@ -99,20 +137,44 @@ class CData
 
  private:
    std::string keyWord = ""; // key word for concordance
+   size_t count = 0; // number of occurrences of the key word
    // linked list containing before and after context strings
    CList context;
-   
+   // token positions of the key word, used instead of context
+   // if the CData was created with a position (see DataIn)
+   PostingList positions;
+
+   /**
+    * lnodeBytes
+    * Get the bytes used by an LNode holding a pair of context strings.
+    * @param before before context string
+    * @param after after context string
+    * @return size of the node plus characters stored outside the strings
+    */
+   static size_t lnodeBytes(const std::string& before,
+                            const std::string& after);
+
+   /**
+    * updateWidth
+    * Raise CData::width to newWidth if it is larger.
+    * Safe to call from several threads.
+    * @param newWidth length of a before context string
+    */
+   static void updateWidth(int newWidth);
    
    /**
     * operator <<
     * Overload the outstream operator for this class.
-    * Loop through all the nodes in the linked list.
-    * Use reset() and advanceCounter() methods of linked list to
-    * advance a pointer to the linked list node to print.
+    * Walk the nodes of the linked list with a local pointer, so printing
+    * does not change the CData, and several threads may print at once.
+    * With a posting list, rebuild the context strings of each position
+    * from CData::tokens.
+    * If only a sample of the contexts is kept, add a line with the
+    * number of occurrences.
     * Use CData::width to format the before context string.
     * @param os the outstream (ostream) object.
     * @param data CData object that contains the output data
     * @return reference to ostream
     */
-   friend std::ostream& operator<<(std::ostream& os, CData& data);
+   friend std::ostream& operator<<(std::ostream& os, const CData& data);
 };
\ No newline at end of file
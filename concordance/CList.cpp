@@ -33,6 +33,28 @@ void CList::addTail(std::string before, std::string after)
    }
 }
 
+/**
+ * replace
+ * Replace the context strings of a node.
+ * @param index position of the node in the list, from 0
+ * @param before new before context string
+ * @param after new after context string
+ * @pre list contains more than index nodes
+ */
+void CList::replace(size_t index, const std::string& before,
+                    const std::string& after)
+{
+   LNode *curr = this->head;
+   for (size_t i = 0; i < index; i++)
+   {
+      assert(curr != nullptr);
+      curr = curr->next;
+   }
+   assert(curr != nullptr);
+   curr->before = before;
+   curr->after = after;
+}
+
 /**
  * advanceCounter
  * Advance the curListPtr to the next node.
@@ -99,6 +99,17 @@ class CList
     */
    void addTail(std::string before, std::string after);
 
+   /**
+    * replace
+    * Replace the context strings of a node.
+    * @param index position of the node in the list, from 0
+    * @param before new before context string
+    * @param after new after context string
+    * @pre list contains more than index nodes
+    */
+   void replace(size_t index, const std::string& before,
+                const std::string& after);
+
    /**
     * clear
     * Delete all the nodes in the linked list.
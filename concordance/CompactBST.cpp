@@ -0,0 +1,184 @@
+/**
+ * CompactBST.cpp
+ * Definitions for templated class CompactBST.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include "CompactBST.h"
+
+/**
+ * findIndex
+ * Find the node with a key.
+ * @param key key to search for
+ * @return index of the node, or NIL if not found
+ */
+template <class N>
+uint32_t CompactBST<N>::findIndex(const std::string& key) const
+{
+   uint32_t curr = keys.empty() ? NIL : 0; // node 0 is the root
+   while (curr != NIL)
+   {
+      int cmp = keys[curr].compare(key);
+      if (cmp == 0)
+         return curr;
+      curr = (cmp > 0) ? links[curr].left : links[curr].right;
+   }
+   return NIL;
+}
+
+/**
+ * find
+ * Find the item with the same key as item in the tree.
+ * @param item item of type N to find
+ * @return pointer to the item of type N in the tree.
+ *   If not found, returns nullptr.
+ */
+template <class N>
+N* CompactBST<N>::find(const N& item) const
+{
+   uint32_t index = findIndex(keyOf(item));
+   return (index == NIL) ? nullptr : &items[index];
+}
+
+/**
+ * insert
+ * Insert item of type N into the tree.
+ * Item must not already exist in the tree (exception thrown).
+ * @param item of type N to insert.
+ * return true if item was inserted, otherwise false.
+ */
+template <class N>
+bool CompactBST<N>::insert(const N& item)
+{
+   const std::string& key = keyOf(item);
+   uint32_t index = keys.size();
+   if (index == NIL)
+      throw "CompactBST is full.";
+
+   if (index > 0)
+   {
+      // find the link to attach the new node to
+      uint32_t* link = nullptr;
+      uint32_t curr = 0;
+      while (curr != NIL)
+      {
+         int cmp = keys[curr].compare(key);
+         if (cmp == 0)
+            throw "Duplicate nodes not permitted in BST.";
+         link = (cmp > 0) ? &links[curr].left : &links[curr].right;
+         curr = *link;
+      }
+      *link = index;
+   }
+
+   Link none = { NIL, NIL };
+   links.push_back(none);
+   keys.push_back(key);
+   items.push_back(item);
+   return true;
+}
+
+/**
+ * print(int)
+ * Print the nodes of the tree, in order.
+ * @param width used to align right text margin.
+ */
+template <class N>
+void CompactBST<N>::print(int width) const
+{
+   forEach([width](N& item) {
+      std::cout << std::setw(width) << std::right;
+      std::cout << item << std::endl;
+   });
+}
+
+/**
+ * print(int, int)
+ * Print the nodes of the tree, formatting ranges of nodes on nThreads
+ * threads. Same output as print(width).
+ * Calls: printParallel
+ * @param width used to align right text margin.
+ * @param nThreads number of threads used to format the output
+ */
+template <class N>
+void CompactBST<N>::print(int width, int nThreads) const
+{
+   if (nThreads <= 1)
+   {
+      print(width);
+      return;
+   }
+
+   std::vector<N*> ordered;
+   forEach([&ordered](N& item) { ordered.push_back(&item); });
+   printParallel(ordered, width, nThreads, std::cout);
+}
+
+/**
+ * forEach
+ * Call visit on every item in the tree, in order.
+ * Iterative, so a degenerate tree does not overflow the call stack.
+ * @param visit callable taking N&
+ */
+template <class N>
+template <class F>
+void CompactBST<N>::forEach(F visit) const
+{
+   std::vector<uint32_t> path; // nodes whose left subtree is being visited
+   uint32_t curr = keys.empty() ? NIL : 0;
+
+   while (curr != NIL || !path.empty())
+   {
+      while (curr != NIL)
+      {
+         path.push_back(curr);
+         curr = links[curr].left;
+      }
+      curr = path.back();
+      path.pop_back();
+      visit(items[curr]);
+      curr = links[curr].right;
+   }
+}
+
+/**
+ * forEachInRange
+ * Call visit on every item in a range of the tree, in order. Subtrees
+ * outside the range are skipped: the left subtree can only hold items in
+ * the range if its parent is not before it, and the right subtree only
+ * if its parent is not after it.
+ * @param compare callable taking const N&, returning < 0 if the item
+ *   is before the range, 0 if it is in the range, > 0 if after it
+ * @param visit callable taking N&
+ */
+template <class N>
+template <class C, class F>
+void CompactBST<N>::forEachInRange(C compare, F visit) const
+{
+   std::vector<uint32_t> path; // nodes in or after the range, left pending
+   uint32_t curr = keys.empty() ? NIL : 0;
+
+   while (curr != NIL || !path.empty())
+   {
+      while (curr != NIL)
+      {
+         int cmp = compare(items[curr]);
+         if (cmp < 0)
+            curr = links[curr].right;
+         else
+         {
+            path.push_back(curr);
+            curr = links[curr].left;
+         }
+      }
+      if (path.empty())
+         break;
+      curr = path.back();
+      path.pop_back();
+      if (compare(items[curr]) > 0)
+         break; // this node and everything after it is past the range
+      visit(items[curr]);
+      curr = links[curr].right;
+   }
+}
@@ -0,0 +1,130 @@
+/**
+ * CompactBST.h
+ * Declarations for templated class CompactBST<>
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "CData.h"
+#include "ParallelPrint.h"
+
+/**
+ * keyOf
+ * Get the key an item is ordered by in a CompactBST or BTree.
+ * @param item item stored in the tree
+ * @return the key of item
+ */
+inline const std::string& keyOf(const std::string& item) { return item; }
+inline const std::string& keyOf(const CData& item) { return item.getKeyWord(); }
+
+/**
+ * class CompactBST
+ * Class template for an unbalanced binary search tree with the same
+ * interface as BST<N>, laid out for fewer cache misses.
+ * Nodes are numbered in insertion order. The child links of all nodes
+ * are 32-bit indices in one contiguous vector, and the keys are in
+ * another, so a search touches only the links and keys. The items of
+ * type N are kept apart, in a deque, so pointers to them stay valid as
+ * the tree grows.
+ * Items are ordered by keyOf(item), which must be declared for N.
+ * Duplicates not allowed (throws exception).
+ * Use find() first to ensure item in node not already in the tree.
+ */
+template <class N>
+class CompactBST
+{
+public:
+   /**
+    * find
+    * Find the item with the same key as item in the tree.
+    * @param item item of type N to find
+    * @return pointer to the item of type N in the tree.
+    *   If not found, returns nullptr.
+    */
+   N* find(const N& item) const;
+
+   /**
+    * insert
+    * Insert item of type N into the tree.
+    * Item must not already exist in the tree (exception thrown).
+    * @param item of type N to insert.
+    * return true if item was inserted, otherwise false.
+    */
+   bool insert(const N& item);
+
+   /**
+    * print(int)
+    * Print the nodes of the tree, in order.
+    * @param width used to align right text margin. Used in
+    *   cout << setw(width) << right <<
+    * output sequence.
+    */
+   void print(int width) const;
+
+   /**
+    * print(int, int)
+    * Print the nodes of the tree, formatting ranges of nodes on nThreads
+    * threads. Same output as print(width).
+    * Calls: printParallel
+    * @param width used to align right text margin.
+    * @param nThreads number of threads used to format the output
+    */
+   void print(int width, int nThreads) const;
+
+   /**
+    * forEach
+    * Call visit on every item in the tree, in order.
+    * Iterative, so a degenerate tree does not overflow the call stack.
+    * @param visit callable taking N&
+    */
+   template <class F>
+   void forEach(F visit) const;
+
+   /**
+    * forEachInRange
+    * Call visit on every item in a range of the tree, in order. Subtrees
+    * outside the range are skipped.
+    * @param compare callable taking const N&, returning < 0 if the item
+    *   is before the range, 0 if it is in the range, > 0 if after it
+    * @param visit callable taking N&
+    */
+   template <class C, class F>
+   void forEachInRange(C compare, F visit) const;
+
+   /**
+    * size
+    * @return number of items in the tree
+    */
+   size_t size() const { return this->keys.size(); }
+
+private:
+   static const uint32_t NIL = UINT32_MAX; // no child
+
+   /**
+    * Child links of a node.
+    */
+   struct Link
+   {
+      uint32_t left;
+      uint32_t right;
+   };
+
+   std::vector<Link> links; // child links, by node index
+   std::vector<std::string> keys; // keyOf(item), by node index
+   // items, by node index; mutable, since find returns N* (as BST does)
+   mutable std::deque<N> items;
+
+   /**
+    * findIndex
+    * Find the node with a key.
+    * @param key key to search for
+    * @return index of the node, or NIL if not found
+    */
+   uint32_t findIndex(const std::string& key) const;
+};
+
+#include "CompactBST.cpp"
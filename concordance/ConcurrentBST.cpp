@@ -0,0 +1,196 @@
+/**
+ * ConcurrentBST.cpp
+ * Definitions for templated class ConcurrentBST.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include "ConcurrentBST.h"
+
+/**
+ * find
+ * Find the node containing item of type N in the tree.
+ * Child pointers are read with acquire semantics, so a node published
+ * by another thread is seen fully constructed.
+ * @param item item of type N to find
+ * @return pointer to the item of type N in the node.
+ *   If not found, returns nullptr.
+ */
+template <class N>
+N* ConcurrentBST<N>::find(const N& din) const
+{
+   CBNode<N>* curr = this->root.load(std::memory_order_acquire);
+
+   while (curr != nullptr)
+   {
+      N *currItem = curr->getItem();
+
+      if (*currItem == din)
+         return currItem;
+
+      if (*currItem > din)
+         curr = curr->getLeftNodePtr();
+      else
+         curr = curr->getRightNodePtr();
+   }
+   return nullptr;
+}
+
+/**
+ * upsert
+ * Insert item of type N into the tree, or if an equal item is already
+ * present, call update on the item in the tree while holding its node
+ * mutex.
+ * The new node is created at most once. If the compare-and-swap on an
+ * empty child pointer fails, another thread linked a node there first,
+ * and the search continues from that node.
+ * @param item of type N to insert.
+ * @param update callable taking N&, applied to an existing item.
+ * return true if item was inserted, false if update was applied.
+ */
+template <class N>
+template <class F>
+bool ConcurrentBST<N>::upsert(const N& din, F update)
+{
+   CBNode<N>* newNode = nullptr;
+   std::atomic<CBNode<N>*>* link = &this->root;
+
+   while (true)
+   {
+      CBNode<N>* curr = link->load(std::memory_order_acquire);
+
+      if (curr == nullptr)
+      {
+         if (newNode == nullptr)
+            newNode = new CBNode<N>(din);
+
+         // on failure curr is reloaded with the node that won the race
+         if (link->compare_exchange_strong(curr, newNode,
+                                           std::memory_order_release,
+                                           std::memory_order_acquire))
+            return true;
+      }
+
+      N* currItem = curr->getItem();
+
+      if (*currItem > din)
+      {
+         link = &curr->getLeftLink();
+      }
+      else if (*currItem < din)
+      {
+         link = &curr->getRightLink();
+      }
+      else
+      {
+         // equal: another thread got here first, update in place
+         delete newNode;
+         std::lock_guard<std::mutex> guard(curr->getLock());
+         update(*currItem);
+         return false;
+      }
+   }
+}
+
+/**
+ * inOrder
+ * Do an inorder traversal, and print each node.
+ * @param curr node to begin search at.
+ * @param width used for output formatting
+ */
+template <class N>
+void ConcurrentBST<N>::inOrder(CBNode<N> *curr, int leftWidth) const
+{
+   if (curr != nullptr)
+   {
+      inOrder(curr->getLeftNodePtr(), leftWidth);
+
+      std::cout << std::setw(leftWidth) << std::right;
+      std::cout << *(curr->getItem()) << std::endl;
+
+      inOrder(curr->getRightNodePtr(), leftWidth);
+   }
+}
+
+/**
+ * print(int, int)
+ * Print the nodes of the tree, formatting ranges of nodes on nThreads
+ * threads. Same output as print(width).
+ * Calls: printParallel
+ * @param width used to align right text margin.
+ * @param nThreads number of threads used to format the output
+ */
+template <class N>
+void ConcurrentBST<N>::print(int width, int nThreads) const
+{
+   if (nThreads <= 1)
+   {
+      print(width);
+      return;
+   }
+
+   std::vector<N*> items;
+   forEach([&items](N& item) { items.push_back(&item); });
+   printParallel(items, width, nThreads, std::cout);
+}
+
+/**
+ * forEach
+ * Do an inorder traverse, and call visit on each item.
+ * @param curr node to begin traversal at.
+ * @param visit callable taking N&
+ */
+template <class N>
+template <class F>
+void ConcurrentBST<N>::forEach(CBNode<N> *curr, F& visit) const
+{
+   if (curr != nullptr)
+   {
+      forEach(curr->getLeftNodePtr(), visit);
+      visit(*(curr->getItem()));
+      forEach(curr->getRightNodePtr(), visit);
+   }
+}
+
+/**
+ * forEachInRange
+ * Do an inorder traverse of the items in a range, and call visit on
+ * each one. The left subtree can only hold items in the range if this
+ * item is not before it, and the right subtree only if it is not after.
+ * @param curr node to begin traversal at.
+ * @param compare callable taking const N&, returning < 0 if the item
+ *   is before the range, 0 if it is in the range, > 0 if after it
+ * @param visit callable taking N&
+ */
+template <class N>
+template <class C, class F>
+void ConcurrentBST<N>::forEachInRange(CBNode<N> *curr, C& compare,
+                                      F& visit) const
+{
+   if (curr == nullptr)
+      return;
+
+   int cmp = compare(*(curr->getItem()));
+   if (cmp >= 0)
+      forEachInRange(curr->getLeftNodePtr(), compare, visit);
+   if (cmp == 0)
+      visit(*(curr->getItem()));
+   if (cmp <= 0)
+      forEachInRange(curr->getRightNodePtr(), compare, visit);
+}
+
+/**
+ * clear
+ * Delete the nodes in the tree using a post-order traversal.
+ * @params curr node to begin traverse
+ */
+template <class N>
+void ConcurrentBST<N>::clear(CBNode<N> *curr)
+{
+   if (curr == nullptr)
+      return;
+
+   clear(curr->getLeftNodePtr());
+   clear(curr->getRightNodePtr());
+   delete curr;
+}
@@ -0,0 +1,152 @@
+/**
+ * ConcurrentBST.h
+ * Declarations for templated class ConcurrentBST<>
+ */
+
+#pragma once
+
+#include "CBNode.h"
+#include "ParallelPrint.h"
+
+/**
+ * class ConcurrentBST
+ * Class template for an unbalanced binary search tree of templated nodes of
+ * type N that several threads can insert into at the same time.
+ * find() and insert() do not take any locks: a new node is linked into the
+ * tree with a compare-and-swap on the empty child pointer, and a thread that
+ * loses the race continues the search from the node that won.
+ * Nodes are never removed until the tree is destroyed.
+ * Updates to an item that is already in the tree are serialized by the
+ * mutex of the node that holds it (see upsert()), so the updates to one
+ * item are applied in the order the threads arrive, not in any order the
+ * callers chose.
+ * print() must not be called while other threads are still inserting.
+ */
+template <class N>
+class ConcurrentBST
+{
+public:
+   /**
+    * destructor
+    * Delete all the nodes in the tree.
+    * Calls: clear()
+    * @pre no other thread is using the tree
+    * @post 0 nodes in tree, memory for nodes deallocated.
+    */
+   ~ConcurrentBST(){ clear(this->root.load()); }
+
+   /**
+    * find
+    * Find the node containing item of type N in the tree.
+    * Safe to call while other threads are inserting.
+    * @param item item of type N to find
+    * @return pointer to the item of type N in the node.
+    *   If not found, returns nullptr.
+    */
+   N* find(const N& item) const;
+
+   /**
+    * insert
+    * Insert item of type N into the tree.
+    * Unlike BST<N>::insert, a duplicate is not an error, since another
+    * thread may have inserted the same item after the caller's find().
+    * @param item of type N to insert.
+    * return true if item was inserted, false if it was already present.
+    */
+   bool insert(const N& item) { return upsert(item, [](N&) {}); }
+
+   /**
+    * upsert
+    * Insert item of type N into the tree, or if an equal item is already
+    * present, call update on the item in the tree while holding its node
+    * mutex.
+    * @param item of type N to insert.
+    * @param update callable taking N&, applied to an existing item.
+    * return true if item was inserted, false if update was applied.
+    */
+   template <class F>
+   bool upsert(const N& item, F update);
+
+   /**
+    * print(int)
+    * Print the nodes of the tree.
+    * Calls: inOrder
+    * @param width used to align right text margin.
+    * @pre no thread is inserting into the tree
+    */
+   void print(int width) const { inOrder(this->root.load(), width); }
+
+   /**
+    * print(int, int)
+    * Print the nodes of the tree, formatting ranges of nodes on nThreads
+    * threads. Same output as print(width).
+    * Calls: printParallel
+    * @param width used to align right text margin.
+    * @param nThreads number of threads used to format the output
+    */
+   void print(int width, int nThreads) const;
+
+   /**
+    * forEach
+    * Call visit on every item in the tree, in order.
+    * @param visit callable taking N&
+    * @pre no thread is inserting into the tree
+    */
+   template <class F>
+   void forEach(F visit) const { forEach(this->root.load(), visit); }
+
+   /**
+    * forEachInRange
+    * Call visit on every item in a range of the tree, in order. Subtrees
+    * outside the range are skipped.
+    * @param compare callable taking const N&, returning < 0 if the item
+    *   is before the range, 0 if it is in the range, > 0 if after it
+    * @param visit callable taking N&
+    * @pre no thread is inserting into the tree
+    */
+   template <class C, class F>
+   void forEachInRange(C compare, F visit) const {
+                         forEachInRange(this->root.load(), compare, visit); }
+
+private:
+   std::atomic<CBNode<N>*> root{nullptr}; // root node of tree
+
+   /**
+    * inOrder
+    * Do an inorder traverse, and print each node.
+    * @param curr node to begin search at.
+    * @param width used for output formatting
+    */
+   void inOrder(CBNode<N>* curr, int width) const;
+
+   /**
+    * forEach
+    * Do an inorder traverse, and call visit on each item.
+    * @param curr node to begin traversal at.
+    * @param visit callable taking N&
+    */
+   template <class F>
+   void forEach(CBNode<N>* curr, F& visit) const;
+
+   /**
+    * forEachInRange
+    * Do an inorder traverse of the items in a range, and call visit on
+    * each one.
+    * @param curr node to begin traversal at.
+    * @param compare callable taking const N&, returning < 0 if the item
+    *   is before the range, 0 if it is in the range, > 0 if after it
+    * @param visit callable taking N&
+    */
+   template <class C, class F>
+   void forEachInRange(CBNode<N>* curr, C& compare, F& visit) const;
+
+   /**
+    * clear
+    * Delete the nodes in the tree using a post-order traversal.
+    * @params curr node to begin traversal
+    */
+   void clear(CBNode<N>* curr);
+
+};
+
+#include "ConcurrentBST.cpp"
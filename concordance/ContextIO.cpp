@@ -16,13 +16,22 @@
  * buffer. Insert empty strings fewer words in file.
  * Print error message to cerr if corpus file could not be opened.
  * @param fileName file name of input file
+ * @param prefetch read words ahead on a separate thread if true
  * @returns true if the input file could be opened and the key word 
  *   is not an empty string, otherwise false.
  */
-bool ContextIO::init(const std::string fileName)
+bool ContextIO::init(const std::string fileName, bool prefetch)
 {
-   this->fin.open(fileName);
-   if (fin.fail())
+   this->prefetch = prefetch;
+   bool opened = false;
+   if (prefetch)
+      opened = this->reader.open(fileName);
+   else
+   {
+      this->fin.open(fileName);
+      opened = !fin.fail();
+   }
+   if (!opened)
    {
       std::cerr << "The file <" << fileName;
       std::cerr << "> could not be opened, or is not present ";
@@ -36,7 +45,7 @@ bool ContextIO::init(const std::string fileName)
    {
       // if no more words, insert an empty string
       std::string word = "";
-      fin >> word; // on failure/eof, word remains an empty string
+      readWord(word); // on failure/eof, word remains an empty string
       buffer[buff_start] = word;
       buff_start = (buff_start + 1) % BUFFER_SIZE;
    }
@@ -65,14 +74,17 @@ bool ContextIO::loadWord()
 
    // insert next word at buff_start, then increment
    // if no more words, insert an empty string
-   fin >> word; // on failure/eof, word remains an empty string
+   readWord(word); // on failure/eof, word remains an empty string
    buffer[buff_start] = word;
    buff_start = (buff_start + 1) % BUFFER_SIZE;
 
    // done when the key word is empty string
    if (buffer[ (buff_start + KEYWORD_OFFSET) % BUFFER_SIZE ] == "")
    {
-      this->fin.close();
+      if (prefetch)
+         this->reader.close();
+      else
+         this->fin.close();
       return false;
    }
 
@@ -105,4 +117,18 @@ void ContextIO::update()
    int length = before.length();
    if (this->leftWidth < length)
       this->leftWidth = length;
-}
\ No newline at end of file
+}
+
+/**
+ * readWord
+ * Read the next word from the corpus file, or from the TokenReader
+ * if prefetch is true.
+ * @param word set to the next word; an empty string on failure/eof
+ */
+void ContextIO::readWord(std::string& word)
+{
+   if (prefetch)
+      reader.next(word);
+   else
+      fin >> word;
+}
@@ -10,6 +10,7 @@
 
 #include <string>
 #include <fstream>
+#include "TokenReader.h"
 
 
 /**
@@ -19,6 +20,8 @@
  * for a BST concordance tree.
  * The buffer uses a "circular buffer" algorithm to insert words, and extract
  * the key word, before context and after context strings.
+ * If prefetch is requested, the words are read ahead on a separate thread
+ * by a TokenReader, so disk reads overlap with indexing.
  */
 class ContextIO
 {
@@ -28,6 +31,10 @@ class ContextIO
    static const int KEYWORD_OFFSET = CONTEXT_SIZE;
    
 public:
+   // longest phrase that getWord() can supply: the key word and the
+   // words of the after context
+   static const int MAX_PHRASE = CONTEXT_SIZE + 1;
+
    /**
     * getKeyWord
     * Get the key word, which is updated by update().
@@ -49,6 +56,16 @@ public:
     */
    std::string getAfter() const { return this->after; }
 
+   /**
+    * getWord
+    * Get a word from the buffer, counting from the key word.
+    * @param offset 0 for the key word, 1 for the next word ...
+    *   up to MAX_PHRASE - 1
+    * @returns the word, or an empty string past the end of the file
+    */
+   std::string getWord(int offset) const
+      { return buffer[(buff_start + KEYWORD_OFFSET + offset) % BUFFER_SIZE]; }
+
    /**
     * getWidth
     * Get the width of the largest before context string.
@@ -63,10 +80,11 @@ public:
     * buffer. Insert empty strings fewer words in file.
     * Print error message to cerr if corpus file could not be opened.
     * @param fileName file name of input file
+    * @param prefetch read words ahead on a separate thread if true
     * @returns true if the input file could be opened and the key word 
     *   is not an empty string, otherwise false.
     */
-   bool init(const std::string fileName);
+   bool init(const std::string fileName, bool prefetch = false);
 
    /**
     * loadWord
@@ -90,6 +108,8 @@ public:
    std::string before = ""; // before context string
    std::string after = ""; // after context string
    std::ifstream fin;
+   TokenReader reader; // reads words ahead if prefetch is true
+   bool prefetch = false;
    int leftWidth = 0; // used to format before context string
    // index to "start" of buffer using circular buffer algorithm
    int buff_start = 0; 
@@ -100,4 +120,12 @@ public:
     * from the buffer.
     */
    void update();
+
+   /**
+    * readWord
+    * Read the next word from the corpus file, or from the TokenReader
+    * if prefetch is true.
+    * @param word set to the next word; an empty string on failure/eof
+    */
+   void readWord(std::string& word);
 };
\ No newline at end of file
@@ -15,6 +15,9 @@
  * Data structure for creating or updating a CData object.
  * Contains concordance key word, before context string, after context
  * string, and an integer that is the length of the before context string.
+ * If position is not -1, it is the position of the key word in the
+ * CData::tokens store, and CData keeps the position instead of the context
+ * strings.
  */
 struct DataIn
 {
@@ -22,7 +25,10 @@ struct DataIn
    std::string before;
    std::string after;
    int width;
-   DataIn(std::string key) : keyWord(key), before(""), after(""), width(0) {}
+   long position;
+   DataIn(std::string key) : keyWord(key), before(""), after(""), width(0),
+                             position(-1) {}
    DataIn(std::string key, std::string before, std::string after, int width) :
-                  keyWord(key), before(before), after(after), width(width) {}
+                  keyWord(key), before(before), after(after), width(width),
+                  position(-1) {}
 };
\ No newline at end of file
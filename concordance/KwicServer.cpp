@@ -0,0 +1,367 @@
+/**
+ * KwicServer.cpp
+ * Definitions for class KwicServer.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "KwicServer.h"
+
+/**
+ * destructor
+ * Stop the workers, close the sockets and remove the socket file.
+ */
+KwicServer::~KwicServer()
+{
+   stop();
+   if (listenFd >= 0)
+   {
+      close(listenFd);
+      unlink(path.c_str());
+   }
+   for (int i = 0; i < 2; i++)
+   {
+      if (wakeFds[i] >= 0)
+         close(wakeFds[i]);
+   }
+}
+
+/**
+ * open
+ * Create the socket and listen for connections. A socket file left at
+ * path by an earlier server is replaced.
+ * @param path file name of the socket
+ * @return true if the socket could be created, otherwise false
+ */
+bool KwicServer::open(const std::string& path)
+{
+   sockaddr_un addr;
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   if (path.length() >= sizeof(addr.sun_path))
+      return false;
+   strcpy(addr.sun_path, path.c_str());
+
+   // remove a stale socket, but never a regular file
+   struct stat info;
+   if (lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+      unlink(path.c_str());
+
+   // the wake pipe never blocks: a full pipe already wakes the poll
+   if (wakeFds[0] < 0 && pipe(wakeFds) != 0)
+      return false;
+   for (int i = 0; i < 2; i++)
+      fcntl(wakeFds[i], F_SETFL, fcntl(wakeFds[i], F_GETFL) | O_NONBLOCK);
+
+   int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (fd < 0)
+      return false;
+   if (bind(fd, (sockaddr*) &addr, sizeof(addr)) != 0 ||
+       listen(fd, BACKLOG) != 0)
+   {
+      close(fd);
+      return false;
+   }
+
+   this->path = path;
+   this->listenFd = fd;
+   return true;
+}
+
+/**
+ * run
+ * Start the workers, then poll the listening socket and the idle
+ * connections until a client sends SHUTDOWN. A connection with something
+ * to read is queued for the workers, and polled again when a worker
+ * hands it back.
+ * @pre open() returned true
+ */
+void KwicServer::run()
+{
+   for (int t = 0; t < nThreads; t++)
+      workers.push_back(std::thread(&KwicServer::work, this));
+
+   std::vector<pollfd> fds;
+   while (!stopping)
+   {
+      // the wake pipe, the listening socket, then the idle connections
+      fds.clear();
+      fds.push_back({wakeFds[0], POLLIN, 0});
+      fds.push_back({listenFd, POLLIN, 0});
+      for (size_t i = 0; i < idle.size(); i++)
+         fds.push_back({idle[i].fd, POLLIN, 0});
+      if (poll(fds.data(), fds.size(), -1) < 0)
+      {
+         if (errno == EINTR)
+            continue;
+         break;
+      }
+
+      // queue the connections with a request, or hung up
+      std::vector<Client> still;
+      bool queued = false;
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         for (size_t i = 0; i < idle.size(); i++)
+         {
+            if (fds[i + 2].revents != 0)
+            {
+               clients.push_back(std::move(idle[i]));
+               queued = true;
+            }
+            else
+               still.push_back(std::move(idle[i]));
+         }
+      }
+      idle.swap(still);
+      if (queued)
+         ready.notify_all();
+
+      // poll the connections the workers have served again
+      if (fds[0].revents != 0)
+      {
+         char buffer[64];
+         while (read(wakeFds[0], buffer, sizeof(buffer)) > 0)
+            ;
+         std::vector<Client> served;
+         {
+            std::lock_guard<std::mutex> guard(lock);
+            served.swap(done);
+         }
+         for (size_t i = 0; i < served.size(); i++)
+         {
+            if (served[i].open)
+               idle.push_back(std::move(served[i]));
+            else
+            {
+               close(served[i].fd);
+               connections--;
+            }
+         }
+      }
+
+      if (fds[1].revents != 0)
+         acceptClient();
+   }
+   stop();
+}
+
+/**
+ * acceptClient
+ * Accept a connection, or refuse it if MAX_CLIENTS are open. An answer
+ * that cannot be sent in SEND_TIMEOUT seconds closes the connection.
+ */
+void KwicServer::acceptClient()
+{
+   int fd = accept(listenFd, nullptr, nullptr);
+   if (fd < 0)
+      return;
+
+   if (connections >= MAX_CLIENTS)
+   {
+      writeAll(fd, "ERROR too many connections\nEND\n");
+      close(fd);
+      return;
+   }
+   // a client that stops reading its answers is dropped, not waited for
+   timeval timeout = {SEND_TIMEOUT, 0};
+   setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+   connections++;
+   idle.push_back(Client{fd, "", true});
+}
+
+/**
+ * wake
+ * Wake the main thread from poll().
+ */
+void KwicServer::wake()
+{
+   char byte = 0;
+   ssize_t count;
+   do
+      count = write(wakeFds[1], &byte, 1);
+   while (count < 0 && errno == EINTR);
+}
+
+/**
+ * stop
+ * Stop accepting connections, let the workers finish, and close
+ * every connection. Requests not yet answered are dropped.
+ */
+void KwicServer::stop()
+{
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      closed = true;
+      // a worker blocked sending to a client that does not read returns
+      for (std::set<int>::iterator fd = busy.begin(); fd != busy.end();
+           fd++)
+         shutdown(*fd, SHUT_RDWR);
+   }
+   ready.notify_all();
+
+   for (size_t t = 0; t < workers.size(); t++)
+      workers[t].join();
+   workers.clear();
+
+   for (size_t i = 0; i < clients.size(); i++)
+      close(clients[i].fd);
+   clients.clear();
+   for (size_t i = 0; i < done.size(); i++)
+      close(done[i].fd);
+   done.clear();
+   for (size_t i = 0; i < idle.size(); i++)
+      close(idle[i].fd);
+   idle.clear();
+   connections = 0;
+}
+
+/**
+ * work
+ * Worker thread: serve queued connections until the server stops.
+ */
+void KwicServer::work()
+{
+   while (true)
+   {
+      Client client;
+      {
+         std::unique_lock<std::mutex> guard(lock);
+         ready.wait(guard, [this]() { return !clients.empty() || closed; });
+         if (closed)
+            return;
+         client = std::move(clients.front());
+         clients.pop_front();
+         busy.insert(client.fd);
+      }
+      serve(client);
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         busy.erase(client.fd);
+         done.push_back(std::move(client));
+      }
+      wake();
+   }
+}
+
+/**
+ * serve
+ * Read what a client has sent, without waiting, and answer each complete
+ * request line. client.open is set to false when the client sends QUIT
+ * or SHUTDOWN or a line longer than MAX_REQUEST, or closes the
+ * connection. The part of a line not yet received is kept in
+ * client.pending, which therefore never grows much past MAX_REQUEST.
+ * @param client connection with something to read
+ */
+void KwicServer::serve(Client& client)
+{
+   char buffer[4096];
+   ssize_t count;
+   do
+      count = recv(client.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+   while (count < 0 && errno == EINTR);
+   if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      return;
+   if (count <= 0)
+   {
+      client.open = false;
+      return;
+   }
+   client.pending.append(buffer, count);
+
+   // answer every complete line received
+   std::string& pending = client.pending;
+   size_t start = 0, end;
+   while (client.open &&
+          (end = pending.find('\n', start)) != std::string::npos)
+   {
+      std::string request = pending.substr(start, end - start);
+      if (!request.empty() && request.back() == '\r')
+         request.pop_back();
+      start = end + 1;
+
+      std::ostringstream out;
+      if (request.length() > MAX_REQUEST)
+      {
+         out << "ERROR request too long\nEND\n";
+         client.open = false;
+      }
+      else
+         client.open = answer(request, out);
+      if (!writeAll(client.fd, out.str()))
+         client.open = false;
+   }
+   pending.erase(0, start);
+
+   // a line already too long is refused before the rest of it arrives
+   if (client.open && pending.length() > MAX_REQUEST)
+   {
+      writeAll(client.fd, "ERROR request too long\nEND\n");
+      client.open = false;
+   }
+}
+
+/**
+ * answer
+ * Answer one request line.
+ * @param request request line, without the newline
+ * @param os stream the answer is formatted into
+ * @return false if the connection should be closed, otherwise true
+ */
+bool KwicServer::answer(const std::string& request, std::ostream& os)
+{
+   size_t space = request.find(' ');
+   std::string command = request.substr(0, space);
+   std::string word = (space == std::string::npos) ?
+                      "" : request.substr(space + 1);
+
+   if (command == "QUIT")
+      return false;
+
+   if (command == "SHUTDOWN")
+   {
+      // the main thread sees it when this connection is handed back
+      stopping = true;
+      os << "END\n";
+      return false;
+   }
+
+   if ((command == "WORD" || command == "PREFIX") && !word.empty())
+      query(word, command == "PREFIX", os);
+   else
+      os << "ERROR expected WORD <word>, PREFIX <prefix> or QUIT\n";
+   os << "END\n";
+   return true;
+}
+
+/**
+ * writeAll
+ * Send a whole string to a socket.
+ * MSG_NOSIGNAL, so a client that has gone away does not raise SIGPIPE.
+ * @param fd connected socket
+ * @param data bytes to send
+ * @return false if the connection failed, otherwise true
+ */
+bool KwicServer::writeAll(int fd, const std::string& data)
+{
+   size_t sent = 0;
+   while (sent < data.length())
+   {
+      ssize_t count = send(fd, data.data() + sent, data.length() - sent,
+                           MSG_NOSIGNAL);
+      if (count < 0 && errno == EINTR)
+         continue;
+      if (count <= 0)
+         return false;
+      sent += count;
+   }
+   return true;
+}
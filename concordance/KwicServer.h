@@ -0,0 +1,171 @@
+/**
+ * KwicServer.h
+ * Declarations for class KwicServer.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * class KwicServer
+ * Answers concordance queries from local clients over a Unix domain
+ * socket, so an index built once can be queried many times.
+ * The main thread accepts connections and polls them; when a client has
+ * sent something, its connection is queued for a small pool of worker
+ * threads. A worker reads what was sent, answers the complete requests
+ * and hands the connection back to be polled again, so an idle client
+ * never holds a worker. At most MAX_CLIENTS connections are open at once;
+ * any more are answered by an ERROR and closed, and so is a client that
+ * does not read its answers. Queries only read the index, so they run on
+ * all the workers at once.
+ *
+ * Protocol: one request per line, each answered by zero or more lines
+ * and then a line "END".
+ *   WORD <key word>    the concordance lines of the key word
+ *   PREFIX <prefix>    the concordance lines of every key word that
+ *                      begins with prefix, in order
+ *   QUIT               close the connection (no answer)
+ *   SHUTDOWN           stop the server (answered by END)
+ * Any other request is answered by "ERROR <message>" and END. A request
+ * line longer than MAX_REQUEST bytes is answered by an ERROR, and the
+ * connection is closed.
+ */
+class KwicServer
+{
+public:
+   /**
+    * Query callback: print the concordance lines for a key word, or for
+    * every key word beginning with a prefix, to a stream.
+    * Called on several threads at once.
+    */
+   typedef std::function<void(const std::string& word, bool prefix,
+                              std::ostream& os)> Query;
+
+   /**
+    * Constructor.
+    * @param query answers WORD and PREFIX requests
+    * @param nThreads number of worker threads
+    */
+   KwicServer(Query query, int nThreads) : query(query), nThreads(nThreads) {}
+
+   static const int MAX_CLIENTS = 256; // most connections open at once
+   static const int BACKLOG = 16; // connections waiting to be accepted
+   static const int SEND_TIMEOUT = 5; // seconds to send one answer
+   static const size_t MAX_REQUEST = 4096; // longest request line, in bytes
+
+   /**
+    * destructor
+    * Stop the workers, close the sockets and remove the socket file.
+    */
+   ~KwicServer();
+
+   /**
+    * open
+    * Create the socket and listen for connections. A socket file left at
+    * path by an earlier server is replaced.
+    * @param path file name of the socket
+    * @return true if the socket could be created, otherwise false
+    */
+   bool open(const std::string& path);
+
+   /**
+    * run
+    * Start the workers and accept connections until a client sends
+    * SHUTDOWN.
+    * @pre open() returned true
+    */
+   void run();
+
+private:
+   /**
+    * A connection to a client.
+    */
+   struct Client
+   {
+      int fd; // connected socket
+      std::string pending; // bytes received after the last newline
+      bool open; // false once the connection should be closed
+   };
+
+   Query query; // answers WORD and PREFIX requests
+   int nThreads; // number of worker threads
+   std::string path = ""; // socket file name
+   int listenFd = -1; // listening socket, or -1
+   int wakeFds[2] = {-1, -1}; // pipe that wakes the main thread's poll
+   std::atomic<bool> stopping{false}; // SHUTDOWN received
+
+   // used only by the main thread
+   std::vector<Client> idle; // connections polled for requests
+   int connections = 0; // open connections: idle, queued or served
+
+   std::vector<std::thread> workers;
+   std::mutex lock; // guards clients, done, busy and closed
+   std::condition_variable ready; // signalled when a client is queued
+   std::deque<Client> clients; // connections with a request to serve
+   std::vector<Client> done; // connections served, to be polled again
+   std::set<int> busy; // sockets being served by a worker
+   bool closed = false; // no more connections will be queued
+
+   /**
+    * acceptClient
+    * Accept a connection, or refuse it if MAX_CLIENTS are open.
+    */
+   void acceptClient();
+
+   /**
+    * wake
+    * Wake the main thread from poll().
+    */
+   void wake();
+
+   /**
+    * work
+    * Worker thread: serve queued connections until the server stops.
+    */
+   void work();
+
+   /**
+    * serve
+    * Read what a client has sent, without waiting, and answer each
+    * complete request line. client.open is set to false when the client
+    * sends QUIT or SHUTDOWN or a line longer than MAX_REQUEST, or closes
+    * the connection.
+    * @param client connection with something to read
+    */
+   void serve(Client& client);
+
+   /**
+    * answer
+    * Answer one request line.
+    * @param request request line, without the newline
+    * @param os stream the answer is formatted into
+    * @return false if the connection should be closed, otherwise true
+    */
+   bool answer(const std::string& request, std::ostream& os);
+
+   /**
+    * stop
+    * Stop accepting connections, let the workers finish, and close
+    * every connection.
+    */
+   void stop();
+
+   /**
+    * writeAll
+    * Send a whole string to a socket.
+    * @param fd connected socket
+    * @param data bytes to send
+    * @return false if the connection failed, otherwise true
+    */
+   static bool writeAll(int fd, const std::string& data);
+};
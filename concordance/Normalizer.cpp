@@ -0,0 +1,23 @@
+/**
+ * Normalizer.cpp
+ * Definitions for the key word normalization classes.
+ */
+
+#include "Normalizer.h"
+
+/**
+ * normalize
+ * Get the normal form of a key word from the memo table, calling the
+ * inner Normalizer the first time a word is seen.
+ * @param word key word, lower case with punctuation stripped
+ * @return the normal form of word
+ */
+std::string MemoNormalizer::normalize(const std::string& word)
+{
+   lookups++;
+
+   auto found = memo.find(word);
+   if (found == memo.end())
+      found = memo.insert(std::make_pair(word, inner.normalize(word))).first;
+   return found->second;
+}
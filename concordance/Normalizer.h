@@ -0,0 +1,73 @@
+/**
+ * Normalizer.h
+ * Declarations for the key word normalization classes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+/**
+ * class Normalizer
+ * Interface for a key word normalization stage, applied to each key word
+ * after stripPunctuation(). Key words with the same normal form (for
+ * example "run", "runs" and "running") share one CData entry.
+ * A Normalizer may keep state between calls, so each thread needs its
+ * own instance.
+ */
+class Normalizer
+{
+public:
+   virtual ~Normalizer() {}
+
+   /**
+    * normalize
+    * Get the normal form of a key word.
+    * @param word key word, lower case with punctuation stripped
+    * @return the normal form of word
+    */
+   virtual std::string normalize(const std::string& word) = 0;
+};
+
+/**
+ * class MemoNormalizer
+ * Wraps another Normalizer with a memo table from each word to its normal
+ * form, so each distinct word is normalized only once.
+ */
+class MemoNormalizer : public Normalizer
+{
+public:
+   /**
+    * Constructor.
+    * @param inner the Normalizer that does the work; must outlive this
+    */
+   MemoNormalizer(Normalizer& inner) : inner(inner) {}
+
+   /**
+    * normalize
+    * Get the normal form of a key word from the memo table, calling the
+    * inner Normalizer the first time a word is seen.
+    * @param word key word, lower case with punctuation stripped
+    * @return the normal form of word
+    */
+   std::string normalize(const std::string& word);
+
+   /**
+    * getLookups
+    * @return number of calls to normalize()
+    */
+   size_t getLookups() const { return this->lookups; }
+
+   /**
+    * getDistinct
+    * @return number of distinct words normalized by the inner Normalizer
+    */
+   size_t getDistinct() const { return this->memo.size(); }
+
+private:
+   Normalizer& inner; // the Normalizer that does the work
+   std::unordered_map<std::string, std::string> memo; // word -> normal form
+   size_t lookups = 0; // calls to normalize()
+};
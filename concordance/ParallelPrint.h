@@ -0,0 +1,88 @@
+/**
+ * ParallelPrint.h
+ * Function template for printing an ordered index on several threads.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * printParallel
+ * Print items in order, each as
+ *    os << std::setw(width) << std::right << *item << std::endl;
+ * The items are split into consecutive ranges. Worker threads format the
+ * ranges into separate string buffers, and the calling thread writes the
+ * buffers to os in order, as each one is finished. The output is the same
+ * bytes as printing the items one by one on a single thread.
+ * operator<< for N must not change anything shared between items.
+ * @param items pointers to the items, in print order
+ * @param width used to align right text margin
+ * @param nThreads number of worker threads
+ * @param os stream to print to
+ */
+template <class N>
+void printParallel(const std::vector<N*>& items, int width, int nThreads,
+                   std::ostream& os)
+{
+   // several ranges per thread, so one slow range does not hold up the rest
+   const size_t RANGES_PER_THREAD = 8;
+   size_t nRanges = nThreads * RANGES_PER_THREAD;
+   if (nRanges > items.size())
+      nRanges = items.size();
+   if (nRanges == 0)
+      return;
+
+   std::vector<std::string> buffers(nRanges);
+   std::vector<bool> done(nRanges, false);
+   std::mutex lock; // guards done
+   std::condition_variable finished; // signalled when a range is done
+   std::atomic<size_t> nextRange(0);
+
+   auto worker = [&]() {
+      size_t r;
+      while ((r = nextRange++) < nRanges)
+      {
+         size_t first = items.size() * r / nRanges;
+         size_t last = items.size() * (r + 1) / nRanges;
+         std::ostringstream out;
+         for (size_t i = first; i < last; i++)
+         {
+            out << std::setw(width) << std::right;
+            out << *items[i] << std::endl;
+         }
+         buffers[r] = out.str();
+
+         std::lock_guard<std::mutex> guard(lock);
+         done[r] = true;
+         finished.notify_one();
+      }
+   };
+
+   std::vector<std::thread> workers;
+   for (int t = 0; t < nThreads; t++)
+      workers.push_back(std::thread(worker));
+
+   // write each range as soon as it and all earlier ranges are done
+   for (size_t r = 0; r < nRanges; r++)
+   {
+      {
+         std::unique_lock<std::mutex> guard(lock);
+         finished.wait(guard, [&]() { return done[r]; });
+      }
+      os << buffers[r];
+      std::string().swap(buffers[r]);
+   }
+   os.flush();
+
+   for (size_t t = 0; t < workers.size(); t++)
+      workers[t].join();
+}
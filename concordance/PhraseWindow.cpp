@@ -0,0 +1,115 @@
+/**
+ * PhraseWindow.cpp
+ * Definitions for class PhraseWindow.
+ */
+
+#include "PhraseWindow.h"
+
+/**
+ * Constructor.
+ * @param n number of words in a phrase
+ */
+PhraseWindow::PhraseWindow(int n) : n(n), words(n), hashes(n, 0),
+                                    usable(n, false), stop(n, false)
+{
+   for (int i = 1; i < n; i++)
+      topPower *= BASE;
+}
+
+/**
+ * push
+ * Add the next word of the corpus, and drop the oldest word if the
+ * window is full.
+ * @param word key word form of the word (punctuation stripped)
+ * @param usable false if the word is empty or a number
+ * @param stop true if the word is a stop word
+ */
+void PhraseWindow::push(const std::string& word, bool isUsable, bool isStop)
+{
+   // slot of the new word; when full, this is the oldest word
+   int slot = (oldest + count) % n;
+
+   if (count == n)
+   {
+      hash -= hashes[oldest] * topPower;
+      if (!usable[oldest])
+         unusable--;
+      oldest = (oldest + 1) % n;
+   }
+   else
+      count++;
+
+   words[slot] = word;
+   hashes[slot] = hashWord(word);
+   usable[slot] = isUsable;
+   stop[slot] = isStop;
+   if (!isUsable)
+      unusable++;
+
+   hash = hash * BASE + hashes[slot];
+}
+
+/**
+ * isValid
+ * Is the window a phrase that belongs in the concordance?
+ * It must be full, every word must be usable, and it must not begin
+ * or end with a stop word.
+ * @return true if the phrase should be indexed
+ */
+bool PhraseWindow::isValid() const
+{
+   int newest = (oldest + n - 1) % n;
+   return count == n && unusable == 0 && !stop[oldest] && !stop[newest];
+}
+
+/**
+ * getPhrase
+ * @return the words in the window, separated by single spaces
+ */
+std::string PhraseWindow::getPhrase() const
+{
+   std::string phrase = words[oldest];
+   for (int i = 1; i < count; i++)
+      phrase += " " + words[(oldest + i) % n];
+   return phrase;
+}
+
+/**
+ * matches
+ * Compare a key word with the phrase, without building the phrase.
+ * @param keyWord key word to compare
+ * @return true if keyWord == getPhrase()
+ */
+bool PhraseWindow::matches(const std::string& keyWord) const
+{
+   size_t pos = 0;
+   for (int i = 0; i < count; i++)
+   {
+      const std::string& word = words[(oldest + i) % n];
+      if (i > 0)
+      {
+         if (pos >= keyWord.length() || keyWord[pos] != ' ')
+            return false;
+         pos++;
+      }
+      if (keyWord.compare(pos, word.length(), word) != 0)
+         return false;
+      pos += word.length();
+   }
+   return pos == keyWord.length();
+}
+
+/**
+ * hashWord
+ * @return FNV-1a hash of a word
+ */
+uint64_t PhraseWindow::hashWord(const std::string& word)
+{
+   uint64_t h = 14695981039346656037ULL;
+   for (size_t i = 0; i < word.length(); i++)
+   {
+      h ^= (unsigned char) word[i];
+      h *= 1099511628211ULL;
+   }
+   return h;
+}
@@ -0,0 +1,90 @@
+/**
+ * PhraseWindow.h
+ * Declarations for class PhraseWindow.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * class PhraseWindow
+ * The last n words of the corpus, used as a phrase (n-gram) key word.
+ * Each word is added once, as it enters the window, together with the
+ * checks the concordance needs (empty, number, stop word), so they are
+ * not repeated for each of the n phrases that contain the word.
+ * The window keeps a rolling polynomial hash of its words:
+ *    hash = h(w0) * B^(n-1) + h(w1) * B^(n-2) + ... + h(wn-1)
+ * which is updated in constant time when a word enters and the oldest
+ * word leaves.
+ */
+class PhraseWindow
+{
+   static const uint64_t BASE = 1099511628211ULL; // hash multiplier B
+
+public:
+   /**
+    * Constructor.
+    * @param n number of words in a phrase
+    */
+   PhraseWindow(int n);
+
+   /**
+    * push
+    * Add the next word of the corpus, and drop the oldest word if the
+    * window is full.
+    * @param word key word form of the word (punctuation stripped)
+    * @param usable false if the word is empty or a number
+    * @param stop true if the word is a stop word
+    */
+   void push(const std::string& word, bool usable, bool stop);
+
+   /**
+    * isValid
+    * Is the window a phrase that belongs in the concordance?
+    * It must be full, every word must be usable, and it must not begin
+    * or end with a stop word.
+    * @return true if the phrase should be indexed
+    */
+   bool isValid() const;
+
+   /**
+    * getHash
+    * @return rolling hash of the words in the window
+    */
+   uint64_t getHash() const { return this->hash; }
+
+   /**
+    * getPhrase
+    * @return the words in the window, separated by single spaces
+    */
+   std::string getPhrase() const;
+
+   /**
+    * matches
+    * Compare a key word with the phrase, without building the phrase.
+    * @param keyWord key word to compare
+    * @return true if keyWord == getPhrase()
+    */
+   bool matches(const std::string& keyWord) const;
+
+ private:
+   int n; // words in a phrase
+   int count = 0; // words pushed, up to n
+   int oldest = 0; // ring index of the first word of the phrase
+   std::vector<std::string> words; // ring buffer of n words
+   std::vector<uint64_t> hashes; // hash of each word in words
+   std::vector<bool> usable; // usable flag of each word in words
+   std::vector<bool> stop; // stop word flag of each word in words
+   int unusable = 0; // number of words in the window that are not usable
+   uint64_t hash = 0; // rolling hash of the window
+   uint64_t topPower = 1; // B^(n-1), weight of the oldest word
+
+   /**
+    * hashWord
+    * @return FNV-1a hash of a word
+    */
+   static uint64_t hashWord(const std::string& word);
+};
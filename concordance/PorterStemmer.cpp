@@ -0,0 +1,367 @@
+/**
+ * PorterStemmer.cpp
+ * Definitions for class PorterStemmer.
+ */
+
+#include "PorterStemmer.h"
+
+/**
+ * normalize
+ * Get the stem of a word.
+ * Words of one or two letters are not changed.
+ * @param word key word, lower case with punctuation stripped
+ * @return the stem of word
+ */
+std::string PorterStemmer::normalize(const std::string& word)
+{
+   for (size_t i = 0; i < word.length(); i++)
+   {
+      if (word[i] < 'a' || word[i] > 'z')
+         return word;
+   }
+   if (word.length() <= 2)
+      return word;
+
+   b = word;
+   k = word.length() - 1;
+   j = 0;
+
+   step1ab();
+   if (k > 0)
+   {
+      step1c();
+      step2();
+      step3();
+      step4();
+      step5();
+   }
+   return b.substr(0, k + 1);
+}
+
+/**
+ * cons
+ * y is a consonant at the start of a word or after a vowel.
+ * @return true if b[i] is a consonant
+ */
+bool PorterStemmer::cons(int i) const
+{
+   switch (b[i])
+   {
+      case 'a': case 'e': case 'i': case 'o': case 'u':
+         return false;
+      case 'y':
+         return (i == 0) ? true : !cons(i - 1);
+      default:
+         return true;
+   }
+}
+
+/**
+ * m
+ * Measure the number of consonant sequences in b[0..j]:
+ * <c><v> gives 0, <c>vc<v> gives 1, <c>vcvc<v> gives 2 ...
+ * @return the measure
+ */
+int PorterStemmer::m() const
+{
+   int n = 0;
+   int i = 0;
+
+   // skip the leading consonants
+   while (i <= j && cons(i))
+      i++;
+
+   while (true)
+   {
+      // vowels
+      while (i <= j && !cons(i))
+         i++;
+      if (i > j)
+         return n;
+      // consonants
+      while (i <= j && cons(i))
+         i++;
+      n++;
+      if (i > j)
+         return n;
+   }
+}
+
+/**
+ * vowelInStem
+ * @return true if b[0..j] contains a vowel
+ */
+bool PorterStemmer::vowelInStem() const
+{
+   for (int i = 0; i <= j; i++)
+   {
+      if (!cons(i))
+         return true;
+   }
+   return false;
+}
+
+/**
+ * doubleCons
+ * @return true if b[i-1..i] is a double consonant
+ */
+bool PorterStemmer::doubleCons(int i) const
+{
+   if (i < 1 || b[i] != b[i - 1])
+      return false;
+   return cons(i);
+}
+
+/**
+ * cvc
+ * @return true if b[i-2..i] is consonant-vowel-consonant and the last
+ *   consonant is not w, x or y (as in hop, but not snow or box)
+ */
+bool PorterStemmer::cvc(int i) const
+{
+   if (i < 2 || !cons(i) || cons(i - 1) || !cons(i - 2))
+      return false;
+   char ch = b[i];
+   return ch != 'w' && ch != 'x' && ch != 'y';
+}
+
+/**
+ * ends
+ * Does b[0..k] end with s? If so, set j to the end of the stem.
+ * @param s suffix
+ * @return true if b[0..k] ends with s
+ */
+bool PorterStemmer::ends(const std::string& s)
+{
+   int length = s.length();
+   if (length > k + 1 || b.compare(k - length + 1, length, s) != 0)
+      return false;
+   j = k - length;
+   return true;
+}
+
+/**
+ * setTo
+ * Replace b[j+1..k] with s, and update k.
+ * @param s new suffix
+ */
+void PorterStemmer::setTo(const std::string& s)
+{
+   b.replace(j + 1, k - j, s);
+   k = j + s.length();
+}
+
+/**
+ * replace
+ * Call setTo(s) if m() > 0.
+ * @param s new suffix
+ */
+void PorterStemmer::replace(const std::string& s)
+{
+   if (m() > 0)
+      setTo(s);
+}
+
+/**
+ * step1ab
+ * Remove plurals and -ed or -ing, e.g.
+ *    caresses -> caress, ponies -> poni, cats -> cat,
+ *    feed -> feed, agreed -> agree, plastered -> plaster,
+ *    motoring -> motor, hopping -> hop, filing -> file
+ */
+void PorterStemmer::step1ab()
+{
+   if (b[k] == 's')
+   {
+      if (ends("sses"))
+         k -= 2;
+      else if (ends("ies"))
+         setTo("i");
+      else if (b[k - 1] != 's')
+         k--;
+   }
+
+   if (ends("eed"))
+   {
+      if (m() > 0)
+         k--;
+   }
+   else if ((ends("ed") || ends("ing")) && vowelInStem())
+   {
+      k = j;
+      if (ends("at"))
+         setTo("ate");
+      else if (ends("bl"))
+         setTo("ble");
+      else if (ends("iz"))
+         setTo("ize");
+      else if (doubleCons(k))
+      {
+         k--;
+         char ch = b[k];
+         if (ch == 'l' || ch == 's' || ch == 'z')
+            k++;
+      }
+      else
+      {
+         j = k;
+         if (m() == 1 && cvc(k))
+            setTo("e");
+      }
+   }
+}
+
+/**
+ * step1c
+ * Turn a final y into i if there is another vowel in the stem.
+ */
+void PorterStemmer::step1c()
+{
+   if (ends("y") && vowelInStem())
+      b[k] = 'i';
+}
+
+/**
+ * step2
+ * Map double suffixes to single ones, e.g. -ization -> -ize,
+ * if the rest of the word has m() > 0.
+ */
+void PorterStemmer::step2()
+{
+   switch (b[k - 1])
+   {
+      case 'a':
+         if (ends("ational")) { replace("ate"); break; }
+         if (ends("tional")) { replace("tion"); break; }
+         break;
+      case 'c':
+         if (ends("enci")) { replace("ence"); break; }
+         if (ends("anci")) { replace("ance"); break; }
+         break;
+      case 'e':
+         if (ends("izer")) { replace("ize"); break; }
+         break;
+      case 'l':
+         if (ends("bli")) { replace("ble"); break; }
+         if (ends("alli")) { replace("al"); break; }
+         if (ends("entli")) { replace("ent"); break; }
+         if (ends("eli")) { replace("e"); break; }
+         if (ends("ousli")) { replace("ous"); break; }
+         break;
+      case 'o':
+         if (ends("ization")) { replace("ize"); break; }
+         if (ends("ation")) { replace("ate"); break; }
+         if (ends("ator")) { replace("ate"); break; }
+         break;
+      case 's':
+         if (ends("alism")) { replace("al"); break; }
+         if (ends("iveness")) { replace("ive"); break; }
+         if (ends("fulness")) { replace("ful"); break; }
+         if (ends("ousness")) { replace("ous"); break; }
+         break;
+      case 't':
+         if (ends("aliti")) { replace("al"); break; }
+         if (ends("iviti")) { replace("ive"); break; }
+         if (ends("biliti")) { replace("ble"); break; }
+         break;
+      case 'g':
+         if (ends("logi")) { replace("log"); break; }
+         break;
+   }
+}
+
+/**
+ * step3
+ * Handle -ic-, -full, -ness etc.
+ */
+void PorterStemmer::step3()
+{
+   switch (b[k])
+   {
+      case 'e':
+         if (ends("icate")) { replace("ic"); break; }
+         if (ends("ative")) { replace(""); break; }
+         if (ends("alize")) { replace("al"); break; }
+         break;
+      case 'i':
+         if (ends("iciti")) { replace("ic"); break; }
+         break;
+      case 'l':
+         if (ends("ical")) { replace("ic"); break; }
+         if (ends("ful")) { replace(""); break; }
+         break;
+      case 's':
+         if (ends("ness")) { replace(""); break; }
+         break;
+   }
+}
+
+/**
+ * step4
+ * Remove -ant, -ence etc. if the rest of the word has m() > 1.
+ */
+void PorterStemmer::step4()
+{
+   bool found = false;
+
+   switch (b[k - 1])
+   {
+      case 'a':
+         found = ends("al");
+         break;
+      case 'c':
+         found = ends("ance") || ends("ence");
+         break;
+      case 'e':
+         found = ends("er");
+         break;
+      case 'i':
+         found = ends("ic");
+         break;
+      case 'l':
+         found = ends("able") || ends("ible");
+         break;
+      case 'n':
+         found = ends("ant") || ends("ement") || ends("ment") || ends("ent");
+         break;
+      case 'o':
+         found = (ends("ion") && j >= 0 && (b[j] == 's' || b[j] == 't')) ||
+                 ends("ou");
+         break;
+      case 's':
+         found = ends("ism");
+         break;
+      case 't':
+         found = ends("ate") || ends("iti");
+         break;
+      case 'u':
+         found = ends("ous");
+         break;
+      case 'v':
+         found = ends("ive");
+         break;
+      case 'z':
+         found = ends("ize");
+         break;
+   }
+
+   if (found && m() > 1)
+      k = j;
+}
+
+/**
+ * step5
+ * Remove a final -e if m() > 1, and change -ll to -l if m() > 1.
+ */
+void PorterStemmer::step5()
+{
+   j = k;
+   if (b[k] == 'e')
+   {
+      int a = m();
+      if (a > 1 || (a == 1 && !cvc(k - 1)))
+         k--;
+   }
+   if (b[k] == 'l' && doubleCons(k) && m() > 1)
+      k--;
+}
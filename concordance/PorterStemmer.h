@@ -0,0 +1,99 @@
+/**
+ * PorterStemmer.h
+ * Declarations for class PorterStemmer.
+ */
+
+#pragma once
+
+#include <string>
+#include "Normalizer.h"
+
+/**
+ * class PorterStemmer
+ * Normalizer that reduces an English word to its stem with the Porter
+ * stemming algorithm (M.F. Porter, "An algorithm for suffix stripping",
+ * Program 14(3), 1980), including the two departures in Porter's own
+ * reference implementation ("bli" -> "ble", "logi" -> "log").
+ * "run", "runs" and "running" all give "run".
+ * Words that are not all lower case letters are returned unchanged.
+ */
+class PorterStemmer : public Normalizer
+{
+public:
+   /**
+    * normalize
+    * Get the stem of a word.
+    * @param word key word, lower case with punctuation stripped
+    * @return the stem of word
+    */
+   std::string normalize(const std::string& word);
+
+private:
+   // the word being stemmed is b[0..k]; j is a general offset into b
+   std::string b;
+   int k = 0;
+   int j = 0;
+
+   /**
+    * cons
+    * @return true if b[i] is a consonant
+    */
+   bool cons(int i) const;
+
+   /**
+    * m
+    * Measure the number of consonant sequences in b[0..j]:
+    * <c><v> gives 0, <c>vc<v> gives 1, <c>vcvc<v> gives 2 ...
+    * @return the measure
+    */
+   int m() const;
+
+   /**
+    * vowelInStem
+    * @return true if b[0..j] contains a vowel
+    */
+   bool vowelInStem() const;
+
+   /**
+    * doubleCons
+    * @return true if b[i-1..i] is a double consonant
+    */
+   bool doubleCons(int i) const;
+
+   /**
+    * cvc
+    * @return true if b[i-2..i] is consonant-vowel-consonant and the last
+    *   consonant is not w, x or y (as in hop, but not snow or box)
+    */
+   bool cvc(int i) const;
+
+   /**
+    * ends
+    * Does b[0..k] end with s? If so, set j to the end of the stem.
+    * @param s suffix
+    * @return true if b[0..k] ends with s
+    */
+   bool ends(const std::string& s);
+
+   /**
+    * setTo
+    * Replace b[j+1..k] with s, and update k.
+    * @param s new suffix
+    */
+   void setTo(const std::string& s);
+
+   /**
+    * replace
+    * Call setTo(s) if m() > 0.
+    * @param s new suffix
+    */
+   void replace(const std::string& s);
+
+   // the steps of the algorithm, applied in order
+   void step1ab();
+   void step1c();
+   void step2();
+   void step3();
+   void step4();
+   void step5();
+};
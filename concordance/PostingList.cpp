@@ -0,0 +1,29 @@
+/**
+ * PostingList.cpp
+ * Definitions for class PostingList.
+ */
+
+#include <cassert>
+#include "PostingList.h"
+
+/**
+ * add
+ * Add a position to the end of the list.
+ * The first position is stored as a delta from 0.
+ * @param position token position, larger than the last one added
+ */
+void PostingList::add(uint32_t position)
+{
+   assert(count == 0 || position > last);
+   uint32_t delta = position - last;
+
+   while (delta >= 0x80)
+   {
+      data.push_back((unsigned char) (delta | 0x80));
+      delta >>= 7;
+   }
+   data.push_back((unsigned char) delta);
+
+   last = position;
+   count++;
+}
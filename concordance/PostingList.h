@@ -0,0 +1,87 @@
+/**
+ * PostingList.h
+ * Declarations for class PostingList.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * class PostingList
+ * Compressed list of the token positions where a key word occurs.
+ * Positions are added in increasing order. Each is stored as the
+ * difference from the previous position, encoded as a varint: 7 bits per
+ * byte, with the high bit set on every byte except the last. Most deltas
+ * of a frequent key word fit in one or two bytes.
+ */
+class PostingList
+{
+ public:
+   /**
+    * add
+    * Add a position to the end of the list.
+    * @param position token position, larger than the last one added
+    */
+   void add(uint32_t position);
+
+   /**
+    * size
+    * @return number of positions in the list
+    */
+   size_t size() const { return this->count; }
+
+   /**
+    * empty
+    * @return true if the list has no positions
+    */
+   bool empty() const { return this->count == 0; }
+
+   /**
+    * bytes
+    * @return number of bytes allocated for the encoded positions
+    */
+   size_t bytes() const { return this->data.capacity(); }
+
+   /**
+    * forEach
+    * Decode the positions in order, and call visit on each.
+    * @param visit callable taking uint32_t
+    */
+   template <class F>
+   void forEach(F visit) const;
+
+ private:
+   std::vector<unsigned char> data; // varint encoded deltas
+   uint32_t last = 0; // last position added
+   size_t count = 0; // number of positions
+};
+
+/**
+ * forEach
+ * Decode the positions in order, and call visit on each.
+ * @param visit callable taking uint32_t
+ */
+template <class F>
+void PostingList::forEach(F visit) const
+{
+   uint32_t position = 0;
+   size_t i = 0;
+   while (i < data.size())
+   {
+      uint32_t delta = 0;
+      int shift = 0;
+      unsigned char byte;
+      do
+      {
+         byte = data[i++];
+         delta |= (uint32_t) (byte & 0x7f) << shift;
+         shift += 7;
+      } while (byte & 0x80);
+
+      position += delta;
+      visit(position);
+   }
+}
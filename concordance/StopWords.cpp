@@ -0,0 +1,75 @@
+/**
+ * StopWords.cpp
+ * Definitions for class StopWords.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <random>
+#include "StopWords.h"
+
+/**
+ * load
+ * Add the words in a word list file (separated by white space), in
+ * lower case, since key words are matched in lower case.
+ * @param fileName file name of the word list
+ * @return true if the file could be opened, otherwise false
+ */
+bool StopWords::load(const std::string fileName)
+{
+   std::ifstream fin(fileName);
+   if (fin.fail())
+      return false;
+
+   std::string word;
+   while (fin >> word)
+   {
+      for (size_t i = 0; i < word.length(); i++)
+         word[i] = tolower(static_cast<unsigned char>(word[i]));
+      add(word);
+   }
+   return true;
+}
+
+/**
+ * build
+ * Build the Bloom filter and the BST from the words added.
+ * The words are inserted into the BST in a shuffled order, since
+ * word lists are often sorted and would make the BST a linked list.
+ * Duplicate words are added once.
+ */
+void StopWords::build()
+{
+   // fixed seed, so the tree shape is the same on every run
+   std::shuffle(pending.begin(), pending.end(), std::mt19937(1));
+
+   filter.init(count + pending.size());
+   words.forEach([this](std::string& word) {
+      filter.add(BloomFilter::hashWord(word));
+   });
+
+   for (size_t i = 0; i < pending.size(); i++)
+   {
+      if (words.find(pending[i]) == nullptr)
+      {
+         words.insert(pending[i]);
+         filter.add(BloomFilter::hashWord(pending[i]));
+         count++;
+      }
+   }
+   std::vector<std::string>().swap(pending);
+}
+
+/**
+ * contains
+ * Test if a word is a stop word.
+ * @param word key word to test
+ * @return true if the word is in one of the word lists
+ */
+bool StopWords::contains(const std::string& word) const
+{
+   if (!filter.mayContain(BloomFilter::hashWord(word)))
+      return false;
+   return words.find(word) != nullptr;
+}
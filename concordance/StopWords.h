@@ -0,0 +1,75 @@
+/**
+ * StopWords.h
+ * Declarations for class StopWords.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "BloomFilter.h"
+#include "BST.h"
+
+/**
+ * class StopWords
+ * The set of words excluded from the concordance, loaded from one or
+ * more word lists.
+ * A BloomFilter sits in front of the exact BST<string>, so most words
+ * that are not stop words are rejected with a few bit probes, without
+ * searching the tree.
+ * Words are added with load() or add(), then build() must be called
+ * before contains(). contains() may be called from several threads.
+ */
+class StopWords
+{
+public:
+   /**
+    * load
+    * Add the words in a word list file (separated by white space), in
+    * lower case, since key words are matched in lower case.
+    * @param fileName file name of the word list
+    * @return true if the file could be opened, otherwise false
+    */
+   bool load(const std::string fileName);
+
+   /**
+    * add
+    * Add a word.
+    * @param word word to exclude
+    */
+   void add(const std::string& word) { this->pending.push_back(word); }
+
+   /**
+    * build
+    * Build the Bloom filter and the BST from the words added.
+    * The words are inserted into the BST in a shuffled order, since
+    * word lists are often sorted and would make the BST a linked list.
+    */
+   void build();
+
+   /**
+    * contains
+    * Test if a word is a stop word.
+    * @param word key word to test
+    * @return true if the word is in one of the word lists
+    */
+   bool contains(const std::string& word) const;
+
+   /**
+    * size
+    * @return number of distinct stop words
+    */
+   size_t size() const { return this->count; }
+
+   /**
+    * getFilter
+    * @return the Bloom filter in front of the exact set
+    */
+   const BloomFilter& getFilter() const { return this->filter; }
+
+private:
+   std::vector<std::string> pending; // words added since build()
+   BloomFilter filter; // rejects most words that are not stop words
+   BST<std::string> words; // exact set of stop words
+   size_t count = 0; // number of words in the BST
+};
@@ -0,0 +1,60 @@
+/**
+ * Timer.h
+ * Declarations for class Timer.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * class Timer
+ * Measures the wall clock time of each phase of a run and prints it
+ * to cerr. Does nothing if not enabled.
+ */
+class Timer
+{
+ public:
+   /**
+    * Constructor.
+    * Start timing the first phase.
+    * @param enabled print times if true
+    */
+   Timer(bool enabled) : enabled(enabled),
+                         start(std::chrono::steady_clock::now()) {}
+
+   /**
+    * elapsed
+    * Get the time since the current phase started.
+    * @returns elapsed time in seconds
+    */
+   double elapsed() const
+   {
+      std::chrono::duration<double> time =
+                                 std::chrono::steady_clock::now() - start;
+      return time.count();
+   }
+
+   /**
+    * report
+    * Print the time taken by the phase that just ended, then start
+    * timing the next phase.
+    * @param phase name of the phase that just ended
+    */
+   void report(const std::string phase)
+   {
+      if (enabled)
+      {
+         std::cerr << phase << ": " << std::fixed << std::setprecision(4);
+         std::cerr << elapsed() << " s" << std::endl;
+      }
+      start = std::chrono::steady_clock::now();
+   }
+
+ private:
+   bool enabled; // print times if true
+   std::chrono::steady_clock::time_point start; // start of current phase
+};
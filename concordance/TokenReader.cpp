@@ -0,0 +1,139 @@
+/**
+ * TokenReader.cpp
+ * Definitions for class TokenReader.
+ */
+
+#include <cctype>
+#include "TokenReader.h"
+
+/**
+ * open
+ * Open the file and start the reader thread.
+ * @param fileName file name of input file
+ * @returns true if the file could be opened, otherwise false
+ */
+bool TokenReader::open(const std::string fileName)
+{
+   this->fin.open(fileName, std::ios::binary);
+   if (fin.fail())
+      return false;
+
+   done = false;
+   stopped = false;
+   reader = std::thread(&TokenReader::readAhead, this);
+   return true;
+}
+
+/**
+ * next
+ * Get the next word in the file.
+ * Waits for the reader thread if no words are queued.
+ * @param word set to the next word, or an empty string at end of file
+ * @returns true if a word was read, false at end of file
+ */
+bool TokenReader::next(std::string& word)
+{
+   while (currIndex >= current.size())
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      notEmpty.wait(guard, [this]() { return !batches.empty() || done; });
+      if (batches.empty())
+      {
+         word = "";
+         return false;
+      }
+      current.swap(batches.front());
+      batches.pop_front();
+      currIndex = 0;
+      notFull.notify_one();
+   }
+
+   word.swap(current[currIndex++]);
+   return true;
+}
+
+/**
+ * close
+ * Stop the reader thread and close the file.
+ */
+void TokenReader::close()
+{
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      stopped = true;
+   }
+   notFull.notify_one();
+
+   if (reader.joinable())
+      reader.join();
+   if (fin.is_open())
+      fin.close();
+}
+
+/**
+ * readAhead
+ * Reader thread: read the file a block at a time, and queue the words
+ * of each block. A word split across two blocks is carried into the
+ * next batch.
+ */
+void TokenReader::readAhead()
+{
+   std::vector<char> block(BLOCK_SIZE);
+   std::vector<std::string> batch;
+   std::string word = ""; // partial word at the end of a block
+   bool running = true;
+
+   while (running && fin)
+   {
+      fin.read(block.data(), BLOCK_SIZE);
+      std::streamsize count = fin.gcount();
+
+      for (std::streamsize i = 0; i < count; i++)
+      {
+         // same separators as ifstream >> string in the "C" locale
+         if (isspace(static_cast<unsigned char>(block[i])))
+         {
+            if (!word.empty())
+            {
+               batch.push_back(word);
+               word.clear();
+            }
+         }
+         else
+            word += block[i];
+      }
+
+      if (!batch.empty())
+         running = push(batch);
+   }
+
+   if (running && !word.empty())
+   {
+      batch.push_back(word);
+      push(batch);
+   }
+
+   std::lock_guard<std::mutex> guard(lock);
+   done = true;
+   notEmpty.notify_one();
+}
+
+/**
+ * push
+ * Queue a batch of words, waiting while the queue is full.
+ * @param batch words to queue; left empty
+ * @returns false if close() was called, otherwise true
+ */
+bool TokenReader::push(std::vector<std::string>& batch)
+{
+   std::unique_lock<std::mutex> guard(lock);
+   notFull.wait(guard, [this]() {
+      return batches.size() < (size_t) MAX_BATCHES || stopped; });
+   if (stopped)
+      return false;
+
+   batches.push_back(std::vector<std::string>());
+   batches.back().swap(batch);
+   notEmpty.notify_one();
+   return true;
+}
@@ -0,0 +1,86 @@
+/**
+ * TokenReader.h
+ * Declarations for class TokenReader.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * class TokenReader
+ * Reads the words of a corpus text file on a separate thread.
+ * The reader thread reads the file in large blocks, splits each block into
+ * words (the same words as ifstream >> string), and places the words of
+ * each block in a batch on a bounded queue. next() takes words from the
+ * queue, so reading the file overlaps with the work done on each word.
+ */
+class TokenReader
+{
+   static const int BLOCK_SIZE = 1 << 20; // bytes read per block
+   static const int MAX_BATCHES = 4; // batches queued ahead of next()
+
+public:
+   /**
+    * destructor
+    * Stop the reader thread if it is still running.
+    */
+   ~TokenReader() { close(); }
+
+   /**
+    * open
+    * Open the file and start the reader thread.
+    * @param fileName file name of input file
+    * @returns true if the file could be opened, otherwise false
+    */
+   bool open(const std::string fileName);
+
+   /**
+    * next
+    * Get the next word in the file.
+    * Waits for the reader thread if no words are queued.
+    * @param word set to the next word, or an empty string at end of file
+    * @returns true if a word was read, false at end of file
+    */
+   bool next(std::string& word);
+
+   /**
+    * close
+    * Stop the reader thread and close the file.
+    */
+   void close();
+
+ private:
+   std::ifstream fin;
+   std::thread reader;
+   std::mutex lock; // guards batches, done and stopped
+   std::condition_variable notEmpty; // signalled when a batch is queued
+   std::condition_variable notFull; // signalled when a batch is taken
+   std::deque<std::vector<std::string> > batches; // words read ahead
+   bool done = false; // reader has queued the last batch
+   bool stopped = false; // close() was called
+   std::vector<std::string> current; // batch being consumed by next()
+   size_t currIndex = 0; // index of the next word in current
+
+   /**
+    * readAhead
+    * Reader thread: read the file a block at a time, and queue the words
+    * of each block. A word split across two blocks is carried into the
+    * next batch.
+    */
+   void readAhead();
+
+   /**
+    * push
+    * Queue a batch of words, waiting while the queue is full.
+    * @param batch words to queue; left empty
+    * @returns false if close() was called, otherwise true
+    */
+   bool push(std::vector<std::string>& batch);
+};
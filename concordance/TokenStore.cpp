@@ -0,0 +1,110 @@
+/**
+ * TokenStore.cpp
+ * Definitions for class TokenStore.
+ */
+
+#include <algorithm>
+#include "TokenStore.h"
+
+/**
+ * add
+ * Add the next word of the corpus.
+ * @param word the word, as read from the corpus file
+ * @return position of the word
+ */
+uint32_t TokenStore::add(const std::string& word)
+{
+   if (fileStarts.empty())
+      beginFile();
+
+   auto found = wordIds.find(word);
+   if (found == wordIds.end())
+   {
+      found = wordIds.insert(std::make_pair(word, words.size())).first;
+      words.push_back(word);
+   }
+   ids.push_back(found->second);
+   return ids.size() - 1;
+}
+
+/**
+ * getBefore
+ * Build the before context string for the key word at position.
+ * Positions before the start of the file are empty words, as in the
+ * ContextIO buffer.
+ * @param position position of the key word
+ * @return before context string
+ */
+std::string TokenStore::getBefore(uint32_t position) const
+{
+   size_t first, end;
+   getFileRange(position, first, end);
+
+   std::string before = "";
+   for (size_t i = position; i < position + CONTEXT_SIZE; i++)
+   {
+      // i - CONTEXT_SIZE is the context position, kept unsigned
+      if (i >= first + CONTEXT_SIZE)
+         before += words[ids[i - CONTEXT_SIZE]];
+      before += " ";
+   }
+   return before;
+}
+
+/**
+ * getAfter
+ * Build the after context string for the key word at position.
+ * The after context string starts with the key word. Positions past the
+ * end of the file are empty words, as in the ContextIO buffer.
+ * @param position position of the key word
+ * @return after context string
+ */
+std::string TokenStore::getAfter(uint32_t position) const
+{
+   size_t first, end;
+   getFileRange(position, first, end);
+
+   std::string after = "";
+   for (size_t i = position; i <= position + CONTEXT_SIZE; i++)
+   {
+      if (i < end)
+         after += words[ids[i]];
+      after += " ";
+   }
+   return after;
+}
+
+/**
+ * bytes
+ * Counts the id of each position, and each distinct word (string object,
+ * its characters if too long for the string itself, and its map entry).
+ * @return approximate number of bytes used by the store
+ */
+size_t TokenStore::bytes() const
+{
+   size_t total = ids.capacity() * sizeof(uint32_t);
+   for (size_t i = 0; i < words.size(); i++)
+   {
+      size_t heap = (words[i].capacity() > 15) ? words[i].capacity() + 1 : 0;
+      // the map holds a second copy of the word, plus node and bucket
+      total += 2 * (sizeof(std::string) + heap) + 2 * sizeof(void*);
+   }
+   return total;
+}
+
+/**
+ * getFileRange
+ * Get the positions of the corpus file that contains position.
+ * @param position a position in the file
+ * @param first set to the first position of the file
+ * @param end set to one past the last position of the file
+ */
+void TokenStore::getFileRange(size_t position, size_t& first,
+                              size_t& end) const
+{
+   // first file that starts after position
+   auto next = std::upper_bound(fileStarts.begin(), fileStarts.end(),
+                                position);
+   first = *(next - 1);
+   end = (next == fileStarts.end()) ? ids.size() : *next;
+}
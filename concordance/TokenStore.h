@@ -0,0 +1,80 @@
+/**
+ * TokenStore.h
+ * Declarations for class TokenStore.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * class TokenStore
+ * Holds every word of the corpus text, in order, so that the before and
+ * after context strings of a key word can be rebuilt from its position.
+ * Each distinct word is stored once; the corpus is kept as a vector of
+ * 32 bit word ids. Words from different corpus files are never joined in
+ * one context string.
+ */
+class TokenStore
+{
+   static const int CONTEXT_SIZE = 5; // # of words in context strings
+
+public:
+   /**
+    * beginFile
+    * Start a new corpus file. Context strings do not cross the start
+    * of a file.
+    */
+   void beginFile() { fileStarts.push_back(ids.size()); }
+
+   /**
+    * add
+    * Add the next word of the corpus.
+    * @param word the word, as read from the corpus file
+    * @return position of the word
+    */
+   uint32_t add(const std::string& word);
+
+   /**
+    * getBefore
+    * Build the before context string for the key word at position.
+    * Same as ContextIO::getBefore() for that key word.
+    * @param position position of the key word
+    * @return before context string
+    */
+   std::string getBefore(uint32_t position) const;
+
+   /**
+    * getAfter
+    * Build the after context string for the key word at position.
+    * Same as ContextIO::getAfter() for that key word.
+    * @param position position of the key word
+    * @return after context string
+    */
+   std::string getAfter(uint32_t position) const;
+
+   /**
+    * bytes
+    * @return approximate number of bytes used by the store
+    */
+   size_t bytes() const;
+
+ private:
+   std::vector<uint32_t> ids; // word id of each position
+   std::vector<std::string> words; // word of each id
+   std::unordered_map<std::string, uint32_t> wordIds; // id of each word
+   std::vector<size_t> fileStarts; // first position of each file
+
+   /**
+    * getFileRange
+    * Get the positions of the corpus file that contains position.
+    * @param position a position in the file
+    * @param first set to the first position of the file
+    * @param end set to one past the last position of the file
+    */
+   void getFileRange(size_t position, size_t& first, size_t& end) const;
+};
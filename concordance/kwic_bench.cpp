@@ -0,0 +1,1022 @@
+/**
+ * kwic_bench.cpp
+ *
+ * Benchmarks for the concordance index structures.
+ *
+ * Key words are random lower case words drawn from a vocabulary of
+ * <keys> distinct words. Each benchmark prints one line of results for
+ * each configuration to stdout.
+ *
+ * Usage: kwic_bench insert <keys> <maxThreads>
+ *   Insert 4 * <keys> words into one shared index with 1, 2, 4 ...
+ *   <maxThreads> threads, using a ConcurrentBST and a BST guarded by a
+ *   single mutex. After each run the index is checked: every word must be
+ *   found, and an in-order traversal must give each word once, in order.
+ *
+ * Usage: kwic_bench io <corpus_file.txt>
+ *   Build a BST<CData> index of the corpus file with ContextIO reading the
+ *   file directly, and with ContextIO reading ahead on a TokenReader
+ *   thread. Each is timed with a cold cache (the file's pages are dropped
+ *   from the page cache first) and with a warm cache.
+ *
+ * Usage: kwic_bench stem <corpus_file.txt>
+ *   Words per second through the key word normalization stage: no
+ *   stemming, PorterStemmer on every word, and PorterStemmer behind a
+ *   MemoNormalizer.
+ *
+ * Usage: kwic_bench phrase <corpus_file.txt> <repeat>
+ *   Index the phrases (n-grams) of n = 1 .. 6 words of the corpus file,
+ *   read <repeat> times, the way kwic -n does: a rolling hash of the
+ *   phrase window finds the phrases already seen. For each n, prints the
+ *   key words, the occurrences, the time to build the index, its bytes
+ *   (tree nodes, key words and contexts) and the growth of the resident
+ *   set size while it was built.
+ *
+ * Usage: kwic_bench stop <listSize> <probes>
+ *   Lookups per second in a stop word list of <listSize> words, for
+ *   <probes> random words of which about 1 in 10 is on the list. Compares
+ *   a BST<string> built from the sorted list (only for lists of up to
+ *   MAX_SORTED words, since the tree is a linked list), a BST<string>
+ *   built in shuffled order, and StopWords (Bloom filter then BST).
+ *
+ * Usage: kwic_bench tree <keys> <lookups>
+ *   Build a BST<string>, a CompactBST<string> and a BTree<string> of
+ *   <keys> random words, then time <lookups> random finds and one
+ *   in-order traversal of each.
+ *   Cache misses are counted with perf_event_open where the kernel
+ *   allows it (n/a otherwise, e.g. in a VM without a PMU).
+ *
+ * Usage: kwic_bench query <socket> <corpus_file.txt> <clients> <queries>
+ *   Latency of a running kwic -d server. Each of <clients> threads opens
+ *   a connection and sends <queries> WORD requests for random words of
+ *   the corpus file, then <queries> PREFIX requests for their first two
+ *   letters, one request at a time. Prints the latency percentiles and
+ *   the requests per second of each kind.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <malloc.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include "BST.h"
+#include "BTree.h"
+#include "CompactBST.h"
+#include "ConcurrentBST.h"
+#include "ContextIO.h"
+#include "Normalizer.h"
+#include "PhraseWindow.h"
+#include "PorterStemmer.h"
+#include "StopWords.h"
+#include "Timer.h"
+
+using namespace std;
+
+/**
+ * BST guarded by a single mutex, the baseline for ConcurrentBST.
+ */
+struct LockedBST
+{
+   BST<string> tree;
+   mutex lock;
+
+   void upsert(const string &word)
+   {
+      lock_guard<mutex> guard(lock);
+      if (tree.find(word) == nullptr)
+         tree.insert(word);
+   }
+};
+
+/**
+ * Counts the last level cache misses of this thread with perf_event_open.
+ * If the counter can't be opened, count() returns -1.
+ */
+class CacheMisses
+{
+public:
+   CacheMisses()
+   {
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CACHE_MISSES;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+   }
+   ~CacheMisses() { if (fd >= 0) close(fd); }
+
+   void start()
+   {
+      if (fd < 0)
+         return;
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+   }
+
+   long long count()
+   {
+      long long misses = -1;
+      if (fd < 0)
+         return misses;
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd, &misses, sizeof(misses)) != sizeof(misses))
+         misses = -1;
+      return misses;
+   }
+
+private:
+   int fd; // perf event file descriptor, or -1
+};
+
+/**
+ * makeWords
+ * Create a vocabulary of distinct random lower case words.
+ * @param count number of words
+ * @param seed random number seed
+ * @return the words, in random order
+ */
+vector<string> makeWords(size_t count, unsigned seed);
+
+/**
+ * runThreads
+ * Split the words between nThreads threads, and call insert for
+ * each word on its thread.
+ * @return elapsed time in seconds
+ */
+template <class F>
+double runThreads(const vector<string> &words, int nThreads, F insert);
+
+/**
+ * benchInsert
+ * Scaling benchmark and stress test for ConcurrentBST.
+ */
+int benchInsert(size_t keys, int maxThreads);
+
+/**
+ * benchIO
+ * Compare direct and read-ahead ContextIO with cold and warm caches.
+ */
+int benchIO(const string &fileName);
+
+/**
+ * dropCache
+ * Ask the kernel to drop the cached pages of a file.
+ */
+bool dropCache(const string &fileName);
+
+/**
+ * indexCorpus
+ * Build a BST<CData> index of a corpus file.
+ */
+double indexCorpus(const string &fileName, bool prefetch);
+
+/**
+ * benchStem
+ * Throughput of the key word normalization stage.
+ */
+int benchStem(const string &fileName);
+
+/**
+ * benchPhrase
+ * Index time and memory of phrase key words as the phrase length grows.
+ */
+int benchPhrase(const string &fileName, int repeat);
+
+/**
+ * indexPhrases
+ * Build a BST<CData> index of the phrases of n words of a corpus file.
+ */
+double indexPhrases(const string &fileName, int n, int repeat,
+                    const StopWords &stopw, BST<CData> &kwic);
+
+/**
+ * pushKey
+ * Add the next word of the corpus to a phrase window.
+ */
+void pushKey(PhraseWindow &window, const string &wordRaw,
+             const StopWords &stopw);
+
+/**
+ * residentBytes
+ * Resident set size of the process.
+ */
+size_t residentBytes();
+
+/**
+ * benchStop
+ * Compare stop word lookups in a BST and in StopWords.
+ */
+int benchStop(size_t listSize, size_t probes);
+
+/**
+ * benchTree
+ * Compare lookups and traversal in the ordered index layouts.
+ */
+int benchTree(size_t keys, size_t lookups);
+
+/**
+ * benchLayout
+ * Time lookups and an in-order traversal in one index layout.
+ */
+template <class Tree>
+bool benchLayout(const string &name, const vector<string> &words,
+                 const vector<string> &probes);
+
+/**
+ * benchQuery
+ * Latency and throughput of a running kwic -d server.
+ */
+int benchQuery(const string &path, const string &fileName, int clients,
+               size_t queries);
+
+/**
+ * connectServer
+ * Connect to a kwic -d server.
+ */
+int connectServer(const string &path);
+
+/**
+ * sendRequest
+ * Send one request and read its answer.
+ */
+bool sendRequest(int fd, const string &request, string &reply);
+
+int main(int argc, char *argv[])
+{
+   string mode = (argc > 1) ? argv[1] : "";
+
+   if (mode == "insert" && argc == 4)
+      return benchInsert(atol(argv[2]), atoi(argv[3]));
+   if (mode == "io" && argc == 3)
+      return benchIO(argv[2]);
+   if (mode == "stem" && argc == 3)
+      return benchStem(argv[2]);
+   if (mode == "phrase" && argc == 4)
+      return benchPhrase(argv[2], atoi(argv[3]));
+   if (mode == "stop" && argc == 4)
+      return benchStop(atol(argv[2]), atol(argv[3]));
+   if (mode == "tree" && argc == 4)
+      return benchTree(atol(argv[2]), atol(argv[3]));
+   if (mode == "query" && argc == 6)
+      return benchQuery(argv[2], argv[3], atoi(argv[4]), atol(argv[5]));
+
+   cout << "Usage: kwic_bench insert <keys> <maxThreads>" << endl;
+   cout << "       kwic_bench io <corpus_file.txt>" << endl;
+   cout << "       kwic_bench stem <corpus_file.txt>" << endl;
+   cout << "       kwic_bench phrase <corpus_file.txt> <repeat>" << endl;
+   cout << "       kwic_bench stop <listSize> <probes>" << endl;
+   cout << "       kwic_bench tree <keys> <lookups>" << endl;
+   cout << "       kwic_bench query <socket> <corpus_file.txt> <clients>";
+   cout << " <queries>" << endl;
+   return 1;
+}
+
+/**
+ * benchInsert
+ * Scaling benchmark and stress test for ConcurrentBST.
+ * Each word in the vocabulary is inserted 4 times, in random order.
+ * @param keys number of distinct words
+ * @param maxThreads largest number of threads to run
+ * @return 0 if every run produced a correct index, otherwise 1
+ */
+int benchInsert(size_t keys, int maxThreads)
+{
+   vector<string> vocab = makeWords(keys, 1);
+   vector<string> words;
+   for (int r = 0; r < 4; r++)
+      words.insert(words.end(), vocab.begin(), vocab.end());
+   shuffle(words.begin(), words.end(), mt19937(2));
+
+   int errors = 0;
+   cout << "threads  ConcurrentBST(s)  mutex BST(s)  check" << endl;
+   for (int t = 1; t <= maxThreads; t *= 2)
+   {
+      ConcurrentBST<string> ctree;
+      double ctime = runThreads(words, t, [&ctree](const string &w) {
+         ctree.insert(w);
+      });
+
+      LockedBST ltree;
+      double ltime = runThreads(words, t, [&ltree](const string &w) {
+         ltree.upsert(w);
+      });
+
+      // stress check: each word present once and in order
+      size_t count = 0;
+      bool ok = true;
+      string prev = "";
+      ctree.forEach([&](string &w) {
+         ok = ok && (count == 0 || prev < w);
+         prev = w;
+         count++;
+      });
+      ok = ok && count == vocab.size();
+      for (size_t i = 0; i < vocab.size() && ok; i++)
+         ok = ctree.find(vocab[i]) != nullptr;
+      if (!ok)
+         errors++;
+
+      cout << setw(7) << t << fixed << setprecision(4);
+      cout << setw(18) << ctime << setw(14) << ltime;
+      cout << "  " << (ok ? "ok" : "FAILED") << endl;
+   }
+   return errors == 0 ? 0 : 1;
+}
+
+/**
+ * benchIO
+ * Compare direct and read-ahead ContextIO with cold and warm caches.
+ * @param fileName corpus file
+ * @return 0 if the file could be read, otherwise 1
+ */
+int benchIO(const string &fileName)
+{
+   cout << "cache  ContextIO(s)  read-ahead(s)" << endl;
+   for (int cold = 1; cold >= 0; cold--)
+   {
+      if (cold && !dropCache(fileName))
+         return 1;
+      double direct = indexCorpus(fileName, false);
+      if (cold)
+         dropCache(fileName);
+      double ahead = indexCorpus(fileName, true);
+      if (direct < 0 || ahead < 0)
+         return 1;
+
+      cout << (cold ? "cold " : "warm ") << fixed << setprecision(4);
+      cout << setw(14) << direct << setw(15) << ahead << endl;
+   }
+   return 0;
+}
+
+/**
+ * dropCache
+ * Ask the kernel to drop the cached pages of a file, so the next read
+ * comes from disk. Dirty pages are written first.
+ * @param fileName file to drop
+ * @return true if the file could be opened
+ */
+bool dropCache(const string &fileName)
+{
+   int fd = open(fileName.c_str(), O_RDONLY);
+   if (fd < 0)
+   {
+      cerr << "cannot open " << fileName << endl;
+      return false;
+   }
+   fdatasync(fd);
+   posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+   close(fd);
+   return true;
+}
+
+/**
+ * indexCorpus
+ * Build a BST<CData> index of a corpus file, the same way kwic does
+ * but without stop words or punctuation stripping.
+ * @param fileName corpus file
+ * @param prefetch read words ahead on a separate thread if true
+ * @return elapsed time in seconds, or -1 if the file could not be read
+ */
+double indexCorpus(const string &fileName, bool prefetch)
+{
+   Timer timer(false);
+   ContextIO buffer;
+   BST<CData> kwic;
+
+   if (!buffer.init(fileName, prefetch))
+      return -1;
+   do {
+      DataIn din(buffer.getKeyWord(), buffer.getBefore(),
+                 buffer.getAfter(), buffer.getWidth());
+      CData cdata(din);
+      CData* cdPtr = kwic.find(cdata);
+      if (cdPtr == nullptr)
+         kwic.insert(cdata);
+      else
+         cdPtr->update(din);
+   } while (buffer.loadWord());
+
+   return timer.elapsed();
+}
+
+/**
+ * benchStem
+ * Throughput of the key word normalization stage.
+ * The words of the file are lower cased and stripped of punctuation
+ * first, so only the normalization is timed.
+ * @param fileName corpus file
+ * @return 0 if the file could be read, otherwise 1
+ */
+int benchStem(const string &fileName)
+{
+   ifstream fin(fileName);
+   if (fin.fail())
+   {
+      cerr << "cannot open " << fileName << endl;
+      return 1;
+   }
+
+   vector<string> words;
+   string word;
+   while (fin >> word)
+   {
+      string key = "";
+      for (size_t i = 0; i < word.length(); i++)
+      {
+         if (isalnum(static_cast<unsigned char>(word[i])))
+            key += tolower(word[i]);
+      }
+      if (key != "")
+         words.push_back(key);
+   }
+
+   PorterStemmer stemmer;
+   MemoNormalizer memo(stemmer);
+   size_t checksum = 0; // keeps the work from being optimized away
+
+   Timer timer(false);
+   for (size_t i = 0; i < words.size(); i++)
+      checksum += words[i].length();
+   double none = timer.elapsed();
+
+   timer.report("");
+   for (size_t i = 0; i < words.size(); i++)
+      checksum += stemmer.normalize(words[i]).length();
+   double direct = timer.elapsed();
+
+   timer.report("");
+   for (size_t i = 0; i < words.size(); i++)
+      checksum += memo.normalize(words[i]).length();
+   double memoized = timer.elapsed();
+
+   cout << words.size() << " words, " << memo.getDistinct();
+   cout << " distinct (checksum " << checksum << ")" << endl;
+   cout << "stage          words/s" << endl << fixed << setprecision(0);
+   cout << "none     " << setw(14) << words.size() / none << endl;
+   cout << "stem     " << setw(14) << words.size() / direct << endl;
+   cout << "memo stem" << setw(14) << words.size() / memoized << endl;
+   return 0;
+}
+
+/**
+ * benchPhrase
+ * Index time and memory of phrase key words as the phrase length grows.
+ * Each n builds a new index, which is deleted (and its memory handed back
+ * to the system with malloc_trim) before the next, so the growth of the
+ * resident set is that of one index.
+ * @param fileName corpus file
+ * @param repeat number of times the file is read into each index
+ * @return 0 if the file could be read, otherwise 1
+ */
+int benchPhrase(const string &fileName, int repeat)
+{
+   StopWords stopw;
+   stopw.load("stopwords.txt");
+   stopw.build();
+
+   cout << "n        keys  occurrences  index(s)  bytes/occ  index(MB)";
+   cout << "  RSS(MB)" << endl;
+   for (int n = 1; n <= ContextIO::MAX_PHRASE; n++)
+   {
+      size_t rss = residentBytes();
+      size_t keys = 0, occurrences = 0, bytes = 0;
+      double time, grown;
+      {
+         BST<CData> kwic;
+         time = indexPhrases(fileName, n, repeat, stopw, kwic);
+         if (time < 0)
+            return 1;
+         grown = (double) residentBytes() - rss;
+
+         kwic.forEach([&](CData &cdata) {
+            const string &key = cdata.getKeyWord();
+            keys++;
+            occurrences += cdata.getCount();
+            bytes += sizeof(BNode<CData>) + cdata.getContextBytes();
+            if (key.length() > 15)
+               bytes += key.length() + 1;
+         });
+      }
+      malloc_trim(0);
+
+      cout << n << fixed << setw(12) << keys << setw(13) << occurrences;
+      cout << setprecision(3) << setw(10) << time;
+      cout << setprecision(1) << setw(11);
+      cout << (occurrences > 0 ? (double) bytes / occurrences : 0.0);
+      cout << setw(11) << bytes / 1e6 << setw(9) << grown / 1e6 << endl;
+   }
+   return 0;
+}
+
+/**
+ * indexPhrases
+ * Build a BST<CData> index of the phrases of n words of a corpus file,
+ * the same way kwic -n does: a phrase seen before in the same pass over
+ * the file is found by the rolling hash of the window, and the phrase
+ * string is built only for a new phrase.
+ * @param fileName corpus file
+ * @param n number of words in a phrase
+ * @param repeat number of times the file is read into the index
+ * @param stopw stop words; a phrase may not begin or end with one
+ * @param kwic index the phrases are added to
+ * @return elapsed time in seconds, or -1 if the file could not be read
+ */
+double indexPhrases(const string &fileName, int n, int repeat,
+                    const StopWords &stopw, BST<CData> &kwic)
+{
+   Timer timer(false);
+   for (int r = 0; r < repeat; r++)
+   {
+      ContextIO buffer;
+      PhraseWindow window(n);
+      unordered_map<uint64_t, CData*> cache; // index entry of each hash
+
+      if (!buffer.init(fileName))
+         return -1;
+      for (int k = 0; k < n - 1; k++)
+         pushKey(window, buffer.getWord(k), stopw);
+      do {
+         pushKey(window, buffer.getWord(n - 1), stopw);
+         if (!window.isValid())
+            continue;
+
+         DataIn din("", buffer.getBefore(), buffer.getAfter(),
+                    buffer.getWidth());
+         unordered_map<uint64_t, CData*>::iterator found =
+                                                cache.find(window.getHash());
+         if (found != cache.end() &&
+             window.matches(found->second->getKeyWord()))
+         {
+            found->second->update(din);
+            continue;
+         }
+
+         din.keyWord = window.getPhrase();
+         CData cdata(din);
+         CData* cdPtr = kwic.find(cdata);
+         if (cdPtr == nullptr)
+         {
+            kwic.insert(cdata);
+            cdPtr = kwic.find(cdata);
+         }
+         else
+            cdPtr->update(din);
+         cache[window.getHash()] = cdPtr;
+      } while (buffer.loadWord());
+   }
+   return timer.elapsed();
+}
+
+/**
+ * pushKey
+ * Add the next word of the corpus to a phrase window, lower cased and
+ * stripped of punctuation. A word with digits but no letters is a number,
+ * and is not usable.
+ * @param window phrase window
+ * @param wordRaw the word, as read from the corpus
+ * @param stopw stop words
+ */
+void pushKey(PhraseWindow &window, const string &wordRaw,
+             const StopWords &stopw)
+{
+   string word = "";
+   bool digits = false, letters = false;
+   for (size_t i = 0; i < wordRaw.length(); i++)
+   {
+      unsigned char c = wordRaw[i];
+      digits = digits || isdigit(c);
+      letters = letters || isalpha(c);
+      if (isalnum(c))
+         word += tolower(c);
+   }
+   bool usable = word != "" && !(digits && !letters);
+   window.push(word, usable, usable && stopw.contains(word));
+}
+
+/**
+ * residentBytes
+ * Resident set size of the process, read from /proc/self/statm.
+ * @return resident bytes, or 0 if they could not be read
+ */
+size_t residentBytes()
+{
+   ifstream statm("/proc/self/statm");
+   size_t pages = 0, resident = 0;
+   if (!(statm >> pages >> resident))
+      return 0;
+   return resident * sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * benchStop
+ * Compare stop word lookups in a BST<string> and in StopWords.
+ * The list and the words not on it come from one vocabulary, so they are
+ * distinct. Every structure must find the same number of stop words.
+ * @param listSize number of words on the stop word list
+ * @param probes number of words looked up
+ * @return 0
+ */
+int benchStop(size_t listSize, size_t probes)
+{
+   // the sorted BST is a linked list, and its recursive insert and find
+   // would take too long (or overflow the stack) for larger lists
+   const size_t MAX_SORTED = 20000;
+
+   vector<string> vocab = makeWords(listSize * 2, 11);
+   vector<string> list(vocab.begin(), vocab.begin() + listSize);
+
+   // about 1 in 10 lookups is a stop word, as in running text
+   mt19937 rng(12);
+   uniform_int_distribution<size_t> onList(0, listSize - 1);
+   uniform_int_distribution<size_t> offList(listSize, vocab.size() - 1);
+   vector<string> words;
+   for (size_t i = 0; i < probes; i++)
+      words.push_back(vocab[(i % 10 == 0) ? onList(rng) : offList(rng)]);
+
+   vector<string> sorted = list;
+   sort(sorted.begin(), sorted.end());
+   Timer timer(false);
+
+   cout << listSize << " stop words, " << probes << " lookups" << endl;
+   cout << "structure        lookups/s     found" << endl;
+
+   if (listSize <= MAX_SORTED)
+   {
+      BST<string> tree;
+      for (size_t i = 0; i < sorted.size(); i++)
+         tree.insert(sorted[i]);
+      size_t found = 0;
+      timer.report("");
+      for (size_t i = 0; i < words.size(); i++)
+         found += (tree.find(words[i]) != nullptr);
+      double time = timer.elapsed();
+      cout << "sorted BST  " << fixed << setprecision(0);
+      cout << setw(14) << probes / time << setw(10) << found << endl;
+   }
+
+   BST<string> tree;
+   for (size_t i = 0; i < list.size(); i++)
+      tree.insert(list[i]);
+   size_t found = 0;
+   timer.report("");
+   for (size_t i = 0; i < words.size(); i++)
+      found += (tree.find(words[i]) != nullptr);
+   double time = timer.elapsed();
+   cout << "shuffled BST" << fixed << setprecision(0);
+   cout << setw(14) << probes / time << setw(10) << found << endl;
+
+   // StopWords shuffles the list itself, so give it the sorted one
+   StopWords stopw;
+   for (size_t i = 0; i < sorted.size(); i++)
+      stopw.add(sorted[i]);
+   stopw.build();
+   found = 0;
+   timer.report("");
+   for (size_t i = 0; i < words.size(); i++)
+      found += stopw.contains(words[i]);
+   time = timer.elapsed();
+   cout << "StopWords   " << fixed << setprecision(0);
+   cout << setw(14) << probes / time << setw(10) << found;
+   cout << "  (filter " << stopw.getFilter().bytes() << " bytes)" << endl;
+   return 0;
+}
+
+/**
+ * benchTree
+ * Compare lookups and traversal in the ordered index layouts: BST<string>
+ * (a heap node per key), CompactBST<string> (contiguous links and keys)
+ * and BTree<string> (up to 15 keys per node). All are built from the same
+ * words in the same order, so the two binary trees have the same shape.
+ * @param keys number of distinct keys
+ * @param lookups number of finds, each for a random key in the tree
+ * @return 0, or 1 if a layout gave a wrong result
+ */
+int benchTree(size_t keys, size_t lookups)
+{
+   vector<string> words = makeWords(keys, 21);
+   mt19937 rng(22);
+   uniform_int_distribution<size_t> pick(0, keys - 1);
+   vector<string> probes;
+   for (size_t i = 0; i < lookups; i++)
+      probes.push_back(words[pick(rng)]);
+
+   cout << keys << " keys, " << lookups << " lookups" << endl;
+   cout << "layout       ns/find  misses/find  traverse(ms)";
+   cout << "  misses/key" << endl;
+   bool correct = benchLayout<BST<string> >("BST", words, probes);
+   correct &= benchLayout<CompactBST<string> >("CompactBST", words, probes);
+   correct &= benchLayout<BTree<string> >("BTree", words, probes);
+   return correct ? 0 : 1;
+}
+
+/**
+ * benchLayout
+ * Build a Tree of the words, then time the finds of probes and one
+ * in-order traversal, and count their cache misses.
+ * @param name layout name printed in the first column
+ * @param words keys to insert, in insertion order
+ * @param probes keys to find, all in words
+ * @return false if a probe was not found or the traversal was out of
+ *   order, otherwise true
+ */
+template <class Tree>
+bool benchLayout(const string &name, const vector<string> &words,
+                 const vector<string> &probes)
+{
+   Tree tree;
+   for (size_t i = 0; i < words.size(); i++)
+      tree.insert(words[i]);
+
+   CacheMisses counter;
+   Timer timer(false);
+   size_t found = 0;
+   counter.start();
+   timer.report("");
+   for (size_t i = 0; i < probes.size(); i++)
+      found += (tree.find(probes[i]) != nullptr);
+   double findTime = timer.elapsed();
+   long long findMisses = counter.count();
+
+   size_t visited = 0;
+   bool ordered = true;
+   const string *prev = nullptr;
+   counter.start();
+   timer.report("");
+   tree.forEach([&](string &word) {
+      if (prev != nullptr && !(*prev < word))
+         ordered = false;
+      prev = &word;
+      visited++;
+   });
+   double walkTime = timer.elapsed();
+   long long walkMisses = counter.count();
+
+   if (found != probes.size() || visited != words.size() || !ordered)
+   {
+      cout << name << ": wrong result" << endl;
+      return false;
+   }
+
+   cout << left << setw(10) << name << right << fixed << setprecision(1);
+   cout << setw(10) << findTime * 1e9 / probes.size();
+   if (findMisses < 0)
+      cout << setw(13) << "n/a";
+   else
+      cout << setw(13) << (double) findMisses / probes.size();
+   cout << setprecision(2) << setw(14) << walkTime * 1e3;
+   if (walkMisses < 0)
+      cout << setw(12) << "n/a";
+   else
+      cout << setw(12) << (double) walkMisses / words.size();
+   cout << endl;
+   return true;
+}
+
+/**
+ * benchQuery
+ * Latency and throughput of a running kwic -d server. Each client thread
+ * has its own connection, and sends one request at a time: first WORD
+ * requests for random corpus words, then PREFIX requests for their first
+ * two letters.
+ * @param path socket file name of the server
+ * @param fileName corpus file the query words are taken from
+ * @param clients number of client threads
+ * @param queries number of requests of each kind sent by each client
+ * @return 0, or 1 if the corpus could not be read or a request failed
+ */
+int benchQuery(const string &path, const string &fileName, int clients,
+               size_t queries)
+{
+   // query words: corpus words in lower case, punctuation stripped
+   vector<string> words;
+   ifstream fin(fileName);
+   string word;
+   while (fin >> word)
+   {
+      string key = "";
+      for (size_t i = 0; i < word.length(); i++)
+      {
+         if (isalnum(static_cast<unsigned char>(word[i])))
+            key += tolower(static_cast<unsigned char>(word[i]));
+      }
+      if (key.length() >= 2)
+         words.push_back(key);
+   }
+   if (words.empty())
+   {
+      cout << "No query words in <" << fileName << ">" << endl;
+      return 1;
+   }
+
+   cout << clients << " clients, " << queries << " requests each" << endl;
+   cout << "request   p50(us)   p90(us)   p99(us)   max(us)  requests/s";
+   cout << "   bytes/reply" << endl;
+
+   for (int prefix = 0; prefix <= 1; prefix++)
+   {
+      vector<vector<double> > latencies(clients);
+      vector<size_t> bytes(clients, 0);
+      atomic<bool> failed(false);
+      Timer timer(false);
+
+      vector<thread> threads;
+      for (int c = 0; c < clients; c++)
+      {
+         threads.push_back(thread([&, c]() {
+            int fd = connectServer(path);
+            if (fd < 0)
+            {
+               failed = true;
+               return;
+            }
+            mt19937 rng(100 + c);
+            uniform_int_distribution<size_t> pick(0, words.size() - 1);
+            string reply;
+            for (size_t q = 0; q < queries && !failed; q++)
+            {
+               const string &w = words[pick(rng)];
+               string request = prefix ? "PREFIX " + w.substr(0, 2) :
+                                         "WORD " + w;
+               auto start = chrono::steady_clock::now();
+               if (!sendRequest(fd, request, reply))
+                  failed = true;
+               chrono::duration<double> time =
+                                 chrono::steady_clock::now() - start;
+               latencies[c].push_back(time.count() * 1e6);
+               bytes[c] += reply.length();
+            }
+            sendRequest(fd, "QUIT", reply);
+            close(fd);
+         }));
+      }
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      double elapsed = timer.elapsed();
+
+      if (failed)
+      {
+         cout << "Request to <" << path << "> failed" << endl;
+         return 1;
+      }
+
+      vector<double> all;
+      size_t totalBytes = 0;
+      for (int c = 0; c < clients; c++)
+      {
+         all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+         totalBytes += bytes[c];
+      }
+      sort(all.begin(), all.end());
+      auto percentile = [&all](double p) {
+         return all[(size_t) (p * (all.size() - 1))];
+      };
+
+      cout << (prefix ? "PREFIX " : "WORD   ") << fixed << setprecision(1);
+      cout << setw(10) << percentile(0.5) << setw(10) << percentile(0.9);
+      cout << setw(10) << percentile(0.99) << setw(10) << all.back();
+      cout << setprecision(0) << setw(12) << all.size() / elapsed;
+      cout << setw(14) << totalBytes / all.size() << endl;
+   }
+   return 0;
+}
+
+/**
+ * connectServer
+ * Connect to a kwic -d server.
+ * @param path socket file name of the server
+ * @return connected socket, or -1 if the connection failed
+ */
+int connectServer(const string &path)
+{
+   sockaddr_un addr;
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   if (path.length() >= sizeof(addr.sun_path))
+      return -1;
+   strcpy(addr.sun_path, path.c_str());
+
+   int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (fd >= 0 && connect(fd, (sockaddr*) &addr, sizeof(addr)) != 0)
+   {
+      close(fd);
+      fd = -1;
+   }
+   return fd;
+}
+
+/**
+ * sendRequest
+ * Send one request line and read its answer, up to and including the
+ * END line. QUIT has no answer.
+ * @param fd connected socket
+ * @param request request, without the newline
+ * @param reply set to the answer
+ * @return false if the connection failed, otherwise true
+ */
+bool sendRequest(int fd, const string &request, string &reply)
+{
+   string line = request + "\n";
+   if (send(fd, line.data(), line.length(), MSG_NOSIGNAL) !=
+       (ssize_t) line.length())
+      return false;
+
+   reply.clear();
+   if (request == "QUIT")
+      return true;
+
+   char buffer[4096];
+   while (true)
+   {
+      size_t n = reply.length();
+      if (n >= 4 && reply.compare(n - 4, 4, "END\n") == 0 &&
+          (n == 4 || reply[n - 5] == '\n'))
+         return true;
+      ssize_t count = read(fd, buffer, sizeof(buffer));
+      if (count <= 0)
+         return false;
+      reply.append(buffer, count);
+   }
+}
+
+/**
+ * runThreads
+ * Split the words between nThreads threads, and call insert for
+ * each word on its thread.
+ * @param words words to insert
+ * @param nThreads number of threads
+ * @param insert callable taking const string&, called once for each word
+ * @return elapsed time in seconds
+ */
+template <class F>
+double runThreads(const vector<string> &words, int nThreads, F insert)
+{
+   vector<thread> workers;
+   auto start = chrono::steady_clock::now();
+
+   for (int t = 0; t < nThreads; t++)
+   {
+      workers.push_back(thread([&, t]() {
+         // interleaved slices, so every thread touches the whole tree
+         for (size_t i = t; i < words.size(); i += nThreads)
+            insert(words[i]);
+      }));
+   }
+   for (size_t t = 0; t < workers.size(); t++)
+      workers[t].join();
+
+   chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+   return elapsed.count();
+}
+
+/**
+ * makeWords
+ * Create a vocabulary of distinct random lower case words.
+ * Words are 3 to 12 letters long.
+ * @param count number of words
+ * @param seed random number seed
+ * @return the words, in random order
+ */
+vector<string> makeWords(size_t count, unsigned seed)
+{
+   mt19937 rng(seed);
+   uniform_int_distribution<int> letter('a', 'z');
+   uniform_int_distribution<int> length(3, 12);
+   BST<string> seen;
+   vector<string> words;
+
+   while (words.size() < count)
+   {
+      string word(length(rng), ' ');
+      for (size_t i = 0; i < word.length(); i++)
+         word[i] = letter(rng);
+      if (seen.find(word) == nullptr)
+      {
+         seen.insert(word);
+         words.push_back(word);
+      }
+   }
+   return words;
+}
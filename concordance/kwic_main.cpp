@@ -11,43 +11,267 @@
  * five words before and after the key word, if present. A file named
  * "stopwords.txt" is used to create a list of words to exclude from the
  * concordance. If the stop words file is absent, the concordance is
- * created with all the words in the corpus text.
+ * created with all the words in the corpus text. More word lists to
+ * exclude can be given with -x.
  * 
  * Concordance output is printed to stdout. Output is formatted such that
  * the keywords are aligned on their left margin.
  * 
- * Usage: kwic <corpus_file.txt>
+ * More than one corpus file may be given; they are combined into a single
+ * concordance. With -j, several threads read the files at the same time
+ * and insert into a shared ConcurrentBST. Each file is read by one thread,
+ * so with a single corpus file -j has no effect: the file is indexed on
+ * one thread, in the layout chosen with -i. The contexts of a key word
+ * found in more than one file are in the order the threads added them,
+ * so they can differ from the output without -j.
+ * 
+ * With -a, each corpus file is read and split into words on a separate
+ * thread (TokenReader), so disk reads overlap with building the index.
+ * With -t, the time taken to build and to print the index is printed to
+ * stderr.
+ * 
+ * With -c, the index keeps the token positions of each key word as a
+ * compressed posting list, and the context strings are rebuilt from a
+ * TokenStore of the corpus words when printed. -s prints the number of
+ * key words and occurrences, and the bytes used by the contexts, to stderr.
+ * 
+ * With -p, the sorted concordance is split into ranges of key words that
+ * are formatted on several threads, then written in order. The output is
+ * the same as with one thread.
+ * 
+ * With -n, the key words are phrases of n words (n-grams) instead of single
+ * words. A phrase is skipped if any of its words is empty or a number, or
+ * if it begins or ends with a stop word.
+ * 
+ * With -i compact, the index is a CompactBST: the same tree as the BST,
+ * with the nodes in contiguous arrays and 32-bit child indices, so
+ * searches touch less memory. With -i btree, the index is a BTree with up to
+ * 15 keys per node. -j always uses a ConcurrentBST.
+ * 
+ * With -k, at most k contexts are kept for each key word: a uniform random
+ * sample of its occurrences. The number of occurrences is still exact, and
+ * is printed after the sample of each key word that has more than k.
+ * 
+ * With -d, the index is built once and kept in memory, and concordance
+ * queries are answered over a Unix domain socket (see KwicServer) by a
+ * pool of -w threads, instead of printing the concordance.
+ * 
+ * With -S, each key word is reduced to its stem after punctuation is
+ * stripped, so "run", "runs" and "running" share one entry. Stop words are
+ * matched before stemming. Each distinct word is stemmed once per indexing
+ * thread. A WORD query to the -d server is stemmed the same way.
+ * 
+ * Usage: kwic [-j threads | -c] [-p threads] [-n words] [-k contexts]
+ *             [-i bst|compact|btree] [-x exclude.txt ...] [-S] [-a] [-t] [-s]
+ *             [-d socket [-w threads]]
+ *             <corpus_file.txt> [corpus_file.txt ...]
  *   assumes: <stopwords.txt> in same directory as program.
  */
 
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <iomanip>
 #include <regex>
 #include <string>
+#include <thread>
+#include <vector>
 #include "kwic_main.h"
 #include "BST.h"
+#include "BTree.h"
+#include "CompactBST.h"
 #include "ContextIO.h"
+#include "KwicServer.h"
+#include "PhraseWindow.h"
+#include "PorterStemmer.h"
+#include "StopWords.h"
+#include "Timer.h"
 
 using namespace std;
 
 int main(int argc, char *argv[])
 {
-   ContextIO buffer; // handles concordance file input and processing
-   BST<string> stopw; // BST for stop words
-   BST<CData> kwic; // BST for concordance words and context strings
+   KwicOptions opts; // command line options and corpus file names
+   StopWords stopw; // stop words and other excluded words
    int leftWidth = 0; // for printing format
 
-   string fileName = handleArgs(argc, argv);
-   // if error opening file, an empty string returned
-   if (fileName == "")
+   // exit if invalid command line arguments
+   if (!handleArgs(argc, argv, opts))
+      return 1;
+   
+   // exit if an exclusion list could not be read
+   if (!loadStopWords(stopw, opts))
       return 1;
+   CData::sampleSize = opts.sample;
+   Timer timer(opts.timing);
+
+   // several threads share one index when there is more than one file
+   if (opts.threads > 1 && opts.files.size() > 1)
+   {
+      ConcurrentBST<CData> kwic;
+      leftWidth = indexConcurrent(opts, stopw, kwic);
+      if (leftWidth < 0)
+         return 1;
+      timer.report("index");
+      if (opts.stats)
+         printStats(kwic, nullptr);
+      if (!opts.socket.empty())
+         return serveIndex(kwic, leftWidth, opts);
+      kwic.print(leftWidth, opts.printThreads);
+      timer.report("print");
+      return 0;
+   }
+
+   // one thread builds the index, in the layout chosen with -i
+   if (opts.index == "compact")
+   {
+      CompactBST<CData> kwic;
+      return indexAndPrint(kwic, opts, stopw, timer);
+   }
+   if (opts.index == "btree")
+   {
+      BTree<CData> kwic;
+      return indexAndPrint(kwic, opts, stopw, timer);
+   }
+   BST<CData> kwic; // BST for concordance words and context strings
+   return indexAndPrint(kwic, opts, stopw, timer);
+}
+
+/**
+ * indexAndPrint
+ * Add the key words and context strings of all the corpus files to the
+ * index on this thread, then print the concordance, or answer queries
+ * if a socket was given with -d.
+ * Calls: indexFile, serveIndex
+ * @param kwic empty index of concordance words and context strings
+ * @param opts command line options
+ * @param stopw stop words to exclude from the index
+ * @param timer times the index and print phases
+ * @return 0, or 1 if a file could not be read
+ */
+template <class Index>
+int indexAndPrint(Index &kwic, const KwicOptions &opts,
+                  const StopWords &stopw, Timer &timer)
+{
+   int leftWidth = 0; // for printing format
+   TokenStore tokens; // corpus words, if compressed
+   PorterStemmer stemmer; // normalization stage, if stemming
+   MemoNormalizer memo(stemmer); // stem each distinct word once
+   if (opts.compress)
+      CData::tokens = &tokens;
+   for (size_t i = 0; i < opts.files.size(); i++)
+   {
+      int width = indexFile(opts.files[i], opts, stopw, kwic,
+                            opts.compress ? &tokens : nullptr,
+                            opts.stem ? &memo : nullptr);
+      // exit if error reading the file
+      if (width < 0)
+         return 1;
+      if (leftWidth < width)
+         leftWidth = width;
+   }
+
+   timer.report("index");
+   if (opts.stats && opts.stem)
+      printStemStats(memo);
+   if (opts.stats)
+      printStats(kwic, CData::tokens);
+   if (!opts.socket.empty())
+      return serveIndex(kwic, leftWidth, opts);
+   kwic.print(leftWidth, opts.printThreads);
+   timer.report("print");
    
-   loadStopWords(stopw);
+   return 0;
+}
+
+/**
+ * serveIndex
+ * Answer concordance queries on the socket given with -d, on a pool of
+ * opts.serverThreads threads, until a client sends SHUTDOWN.
+ * A query word is matched in lower case against the key words. With -S, a
+ * WORD query is stemmed like the key words; a PREFIX query is matched
+ * against the stems as it is.
+ * @param kwic index of concordance words and context strings
+ * @param leftWidth length of the longest before context string
+ * @param opts command line options
+ * @return 0, or 1 if the socket could not be created
+ */
+template <class Index>
+int serveIndex(const Index &kwic, int leftWidth, const KwicOptions &opts)
+{
+   bool stem = opts.stem;
+   auto query = [&kwic, leftWidth, stem](const string &word, bool prefix,
+                                         ostream &os) {
+      string key = word;
+      for (size_t i = 0; i < key.length(); i++)
+         key[i] = tolower(static_cast<unsigned char>(key[i]));
+      // a stemmer keeps state, so each query has its own
+      if (stem && !prefix)
+         key = PorterStemmer().normalize(key);
+
+      // key words that begin with key, or equal key
+      auto compare = [&key, prefix](const CData &cdata) {
+         const string &keyWord = cdata.getKeyWord();
+         if (prefix)
+            return keyWord.compare(0, key.length(), key);
+         return keyWord.compare(key);
+      };
+      kwic.forEachInRange(compare, [&os, leftWidth](CData &cdata) {
+         os << setw(leftWidth) << right << cdata << '\n';
+      });
+   };
+
+   KwicServer server(query, opts.serverThreads);
+   if (!server.open(opts.socket))
+   {
+      cerr << "The socket <" << opts.socket;
+      cerr << "> could not be created." << endl;
+      return 1;
+   }
+   cerr << "Serving queries on " << opts.socket << endl;
+   server.run();
+   return 0;
+}
+
+/**
+ * indexFile
+ * Add the key words and context strings of one corpus file to the index.
+ * If tokens is not null, every word of the file is added to tokens and
+ * the index keeps the position of each key word instead of its context
+ * strings.
+ * Calls: addEntry
+ * @param fileName corpus file name
+ * @param opts command line options
+ * @param stopw stop words to exclude from the index
+ * @param kwic index of concordance words and context strings
+ * @param tokens corpus words for compressed posting lists, or nullptr
+ * @param normalizer normalization stage for key words, or nullptr; kept
+ *   from file to file by the calling thread, so its memo is reused
+ * @return length of the longest before context string,
+ *   or -1 if the file could not be read
+ */
+template <class Index>
+int indexFile(const string &fileName, const KwicOptions &opts,
+              const StopWords &stopw, Index &kwic, TokenStore *tokens,
+              Normalizer *normalizer)
+{
+   ContextIO buffer; // handles concordance file input and processing
+   int leftWidth = 0; // for printing format
+   PhraseWindow window(opts.phrase); // last n words, if indexing phrases
+   PhraseCache cache; // index entry of each phrase hash seen
 
    // initialize the context buffer
    // exit if failure
-   if (!buffer.init(fileName))
-      return 1;
+   if (!buffer.init(fileName, opts.prefetch))
+      return -1;
+   if (tokens != nullptr)
+      tokens->beginFile();
+
+   // load all but the last word of the first phrase
+   for (int k = 0; k < opts.phrase - 1; k++)
+      pushWord(window, buffer.getWord(k), stopw, normalizer);
    
    // loop through the buffer until the last word
    // of the corpus text is processed
@@ -56,83 +280,379 @@ int main(int argc, char *argv[])
       string before = buffer.getBefore();
       string after = buffer.getAfter();
       string keyWord = stripPunctuation(keyWordRaw, true);
+      // each key word is the next word of the file
+      long position = -1;
+      if (tokens != nullptr)
+         position = tokens->add(keyWordRaw);
 
       // keep track of longest before context string
       int length = before.length();
       if (leftWidth < length)
          leftWidth = length;
       
-      // add keyWord and context to BST if key word not a stop word,
+      if (opts.phrase > 1)
+      {
+         // the phrase that starts at the key word ends n - 1 words later
+         pushWord(window, buffer.getWord(opts.phrase - 1), stopw,
+                  normalizer);
+         if (window.isValid())
+         {
+            DataIn din("", before, after, leftWidth);
+            din.position = position;
+            addPhrase(kwic, window, cache, din);
+         }
+      }
+      // add keyWord and context to the index if key word not a stop word,
       // not an empty string and is not a number
-      if ((stopw.find(keyWord) == nullptr) && !isANum(keyWordRaw)
+      else if (!stopw.contains(keyWord) && !isANum(keyWordRaw)
                                           && keyWord != "")
       {
+         if (normalizer != nullptr)
+            keyWord = normalizer->normalize(keyWord);
          DataIn din(keyWord, before, after, leftWidth);
-         CData cdata(din);
-
-         CData* cdPtr = kwic.find(cdata);
-         // insert if keyWord not in BST
-         if (cdPtr == nullptr) // not found
-         {
-            kwic.insert(cdata);
-         }
-         else
-         // update CData since keyWord already in BST
-         {
-            cdPtr->update(din);
-         }
+         din.position = position;
+         addEntry(kwic, din);
       }
       // load new word (or empty string) into the buffer
       // quit if last word processed
    } while (buffer.loadWord());
 
-   kwic.print(buffer.getWidth());
-   
-   return 0;
+   return buffer.getWidth();
+}
+
+/**
+ * printStemStats
+ * Print the number of words stemmed by one thread, and how many of them
+ * were distinct, to cerr.
+ * @param memo memoized stemmer of the thread
+ */
+void printStemStats(const MemoNormalizer &memo)
+{
+   cerr << memo.getLookups() << " words stemmed, ";
+   cerr << memo.getDistinct() << " distinct" << endl;
+}
+
+/**
+ * indexConcurrent
+ * Add the key words and context strings of all the corpus files to a
+ * shared index, using opts.threads threads. Each thread takes the next
+ * unread file until all files are read, with its own memoized stemmer.
+ * The order of the contexts for a key word that occurs in more than one
+ * file depends on the thread scheduling.
+ * Calls: indexFile
+ * @param opts command line options
+ * @param stopw stop words to exclude from the index
+ * @param kwic index of concordance words and context strings
+ * @return length of the longest before context string,
+ *   or -1 if any file could not be read
+ */
+int indexConcurrent(const KwicOptions &opts, const StopWords &stopw,
+                    ConcurrentBST<CData> &kwic)
+{
+   atomic<size_t> nextFile(0); // index of the next file to read
+   vector<int> widths(opts.files.size(), 0); // result for each file
+   vector<thread> workers;
+   size_t nThreads = opts.files.size();
+   if (nThreads > (size_t) opts.threads)
+      nThreads = opts.threads;
+
+   vector<PorterStemmer> stemmers(nThreads); // one per thread, if stemming
+   vector<MemoNormalizer> memos(stemmers.begin(), stemmers.end());
+
+   for (size_t t = 0; t < nThreads; t++)
+   {
+      workers.push_back(thread([&, t]() {
+         size_t i;
+         while ((i = nextFile++) < opts.files.size())
+            widths[i] = indexFile(opts.files[i], opts, stopw, kwic,
+                                  nullptr, opts.stem ? &memos[t] : nullptr);
+      }));
+   }
+   for (size_t t = 0; t < workers.size(); t++)
+      workers[t].join();
+   for (size_t t = 0; opts.stats && opts.stem && t < nThreads; t++)
+   {
+      cerr << "thread " << t << ": ";
+      printStemStats(memos[t]);
+   }
+
+   int leftWidth = 0;
+   for (size_t i = 0; i < widths.size(); i++)
+   {
+      if (widths[i] < 0)
+         return -1;
+      if (leftWidth < widths[i])
+         leftWidth = widths[i];
+   }
+   return leftWidth;
+}
+
+/**
+ * printStats
+ * Print the number of key words and occurrences in the index, and the
+ * bytes used for the contexts, to cerr. The LNode bytes are what the
+ * contexts would take as linked list strings, for comparison with a
+ * compressed index.
+ * @param kwic index of concordance words and context strings
+ * @param tokens corpus words for compressed posting lists, or nullptr
+ */
+template <class Index>
+void printStats(const Index &kwic, const TokenStore *tokens)
+{
+   size_t keyWords = 0, count = 0, contextBytes = 0, listBytes = 0;
+   kwic.forEach([&](CData &cdata) {
+      keyWords++;
+      count += cdata.getCount();
+      contextBytes += cdata.getContextBytes();
+      listBytes += cdata.getListBytes();
+   });
+   if (tokens != nullptr)
+      contextBytes += tokens->bytes();
+
+   double perCount = (count > 0) ? count : 1;
+   cerr << "key words: " << keyWords << endl;
+   cerr << "occurrences: " << count << endl;
+   cerr << fixed << setprecision(1);
+   cerr << "context bytes: " << contextBytes << " (";
+   cerr << contextBytes / perCount << " per occurrence)" << endl;
+   if (tokens != nullptr)
+      cerr << "  of which token store: " << tokens->bytes() << endl;
+   cerr << "LNode string bytes: " << listBytes << " (";
+   cerr << listBytes / perCount << " per occurrence)" << endl;
+}
+
+/**
+ * pushWord
+ * Add the next word of the corpus to the phrase window, with its key word
+ * form and whether it is a number or a stop word.
+ * @param window phrase window
+ * @param wordRaw the word, as read from the corpus
+ * @param stopw stop words
+ * @param normalizer normalization stage for key words, or nullptr
+ */
+void pushWord(PhraseWindow &window, const string &wordRaw,
+              const StopWords &stopw, Normalizer *normalizer)
+{
+   string word = stripPunctuation(wordRaw, true);
+   bool usable = word != "" && !isANum(wordRaw);
+   bool stop = usable && stopw.contains(word);
+   if (usable && normalizer != nullptr)
+      word = normalizer->normalize(word);
+   window.push(word, usable, stop);
+}
+
+/**
+ * addPhrase
+ * Add the phrase in the window and its context strings to the index.
+ * A phrase seen before is found by the rolling hash of the window, and
+ * updated without building the phrase string or searching the index.
+ * Calls: addEntry
+ * @param kwic index of concordance words and context strings
+ * @param window phrase window, isValid() is true
+ * @param cache index entry for each phrase hash seen
+ * @param din context strings, width and position; keyWord is set here
+ */
+template <class Index>
+void addPhrase(Index &kwic, const PhraseWindow &window, PhraseCache &cache,
+               DataIn &din)
+{
+   PhraseCache::iterator found = cache.find(window.getHash());
+   if (found != cache.end() && window.matches(found->second->getKeyWord()))
+   {
+      found->second->update(din);
+      return;
+   }
+
+   // new phrase, or a hash collision
+   din.keyWord = window.getPhrase();
+   CData* cdPtr = addEntry(kwic, din);
+   if (cdPtr != nullptr)
+      cache[window.getHash()] = cdPtr;
+}
+
+/**
+ * addEntry
+ * Add a key word and its context strings to the index.
+ * Insert a new CData if the key word is not in the index,
+ * otherwise update the existing CData.
+ * @param kwic single threaded index (BST, CompactBST or BTree) of
+ *   concordance words and context strings
+ * @param din key word, context strings and width
+ * @return pointer to the CData for the key word in the index
+ */
+template <class Index>
+CData* addEntry(Index &kwic, DataIn &din)
+{
+   CData cdata(din);
+
+   CData* cdPtr = kwic.find(cdata);
+   // insert if keyWord not in index
+   if (cdPtr == nullptr) // not found
+   {
+      kwic.insert(cdata);
+      cdPtr = kwic.find(cdata);
+   }
+   else
+   // update CData since keyWord already in index
+   {
+      cdPtr->update(din);
+   }
+   return cdPtr;
+}
+
+/**
+ * addEntry
+ * Add a key word and its context strings to the concurrent BST.
+ * The find and the insert or update are a single upsert, so two threads
+ * adding the same new key word cannot both insert it.
+ * @param kwic concurrent BST of concordance words and context strings
+ * @param din key word, context strings and width
+ * @return nullptr, since a CData in the concurrent BST may only be
+ *   updated under its node lock
+ */
+CData* addEntry(ConcurrentBST<CData> &kwic, DataIn &din)
+{
+   CData cdata(din);
+
+   kwic.upsert(cdata, [&din](CData &existing) { existing.update(din); });
+   return nullptr;
 }
 
 /**
  * handleArgs
  * Process the command line arguements.
- * If number of args != 2, print error message.
- * @return file name (the command line argument)
+ * Print a usage message if no corpus file is given or an option is invalid.
+ * Options:
+ *   -j <threads>  number of threads that build the index (default 1);
+ *                 one per file, so ignored with a single corpus file
+ *   -p <threads>  number of threads that format the output (default 1)
+ *   -n <words>    index phrases of 1 .. 6 words (default 1)
+ *   -d <socket>   answer queries on a Unix domain socket instead of printing
+ *   -w <threads>  number of threads that answer queries (default 4)
+ *   -i <layout>   index layout: bst (default), compact or btree
+ *   -k <contexts> keep a random sample of at most k contexts per key word
+ *   -x <file>     also exclude the words in file (may be repeated)
+ *   -S            group key words by their Porter stem
+ *   -a            read words ahead on a separate thread
+ *   -t            print index and print times to cerr
+ *   -c            store contexts as compressed posting lists
+ *                 (not with -j or -k)
+ *   -s            print index size statistics to cerr
+ * @param opts options and corpus file names from the command line
+ * @return true if the arguments are valid, otherwise false
  */
-string handleArgs(int argc, char *argv[])
+bool handleArgs(int argc, char *argv[], KwicOptions &opts)
 {
+   bool valid = true;
+
+   for (int i = 1; i < argc && valid; i++)
+   {
+      string arg = argv[i];
+      if (arg == "-j" && i + 1 < argc)
+      {
+         opts.threads = atoi(argv[++i]);
+         valid = opts.threads > 0;
+      }
+      else if (arg == "-p" && i + 1 < argc)
+      {
+         opts.printThreads = atoi(argv[++i]);
+         valid = opts.printThreads > 0;
+      }
+      else if (arg == "-n" && i + 1 < argc)
+      {
+         opts.phrase = atoi(argv[++i]);
+         valid = opts.phrase > 0 && opts.phrase <= ContextIO::MAX_PHRASE;
+      }
+      else if (arg == "-d" && i + 1 < argc)
+         opts.socket = argv[++i];
+      else if (arg == "-w" && i + 1 < argc)
+      {
+         opts.serverThreads = atoi(argv[++i]);
+         valid = opts.serverThreads > 0;
+      }
+      else if (arg == "-i" && i + 1 < argc)
+      {
+         opts.index = argv[++i];
+         valid = opts.index == "bst" || opts.index == "compact" ||
+                 opts.index == "btree";
+      }
+      else if (arg == "-k" && i + 1 < argc)
+      {
+         opts.sample = atoi(argv[++i]);
+         valid = opts.sample > 0;
+      }
+      else if (arg == "-x" && i + 1 < argc)
+         opts.excludeFiles.push_back(argv[++i]);
+      else if (arg == "-S")
+         opts.stem = true;
+      else if (arg == "-a")
+         opts.prefetch = true;
+      else if (arg == "-t")
+         opts.timing = true;
+      else if (arg == "-c")
+         opts.compress = true;
+      else if (arg == "-s")
+         opts.stats = true;
+      else if (arg.length() > 1 && arg[0] == '-')
+         valid = false;
+      else
+         opts.files.push_back(arg);
+   }
+
+   // posting list positions must be added in order, by one thread
+   if (opts.compress && opts.threads > 1)
+      valid = false;
+   // a posting list is delta encoded, so a sampled position can't be replaced
+   if (opts.compress && opts.sample > 0)
+      valid = false;
+
    // check command arguments
-   if (argc != 2)
+   if (!valid || opts.files.empty())
    {
       // remove ./ in front of command line file name
       string progName = argv[0];
       progName = stripPunctuation(progName, false);
 
-      cout << "Usage: " << progName << " <corpus_file.txt>" << endl;
-      return "";
+      cout << "Usage: " << progName;
+      cout << " [-j threads | -c] [-p threads] [-n words] [-k contexts]";
+      cout << " [-i bst|compact|btree] [-x exclude.txt ...]";
+      cout << " [-S] [-a] [-t] [-s] [-d socket [-w threads]]";
+      cout << " <corpus_file.txt> [corpus_file.txt ...]";
+      cout << endl;
+      cout << "  -j reads each file on one thread, so it has no effect";
+      cout << " with a single corpus file" << endl;
+      return false;
    }
-   return argv[1];
+   return true;
 }
 
 /**
  * loadStopWords
- * Load the stop words in stopwords.txt into a BST<string>.
- * If file not found, leave the BST empty.
+ * Load the stop words in stopwords.txt, and the words in each exclusion
+ * list given with -x.
+ * If stopwords.txt is not found, it is skipped.
+ * Print an error message to cerr if an exclusion list is not found.
+ * @param stopw stop words and other excluded words
+ * @param opts command line options
+ * @return false if an exclusion list could not be read, otherwise true
  */
-void loadStopWords(BST<string> &stopw)
+bool loadStopWords(StopWords &stopw, const KwicOptions &opts)
 {
-   string word;
-   ifstream fin;
    // load the stop words, if present
-   fin.open("stopwords.txt");
-   if (!fin.fail())
+   stopw.load("stopwords.txt");
+
+   for (size_t i = 0; i < opts.excludeFiles.size(); i++)
    {
-      while (!fin.eof())
+      if (!stopw.load(opts.excludeFiles[i]))
       {
-         fin >> word;
-         if (stopw.find(word) == nullptr)
-            stopw.insert(word);
+         cerr << "The exclusion list <" << opts.excludeFiles[i];
+         cerr << "> could not be opened." << endl;
+         return false;
       }
-      fin.close();
    }
+
+   stopw.build();
+   return true;
 }
 
 /**
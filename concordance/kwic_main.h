@@ -8,8 +8,43 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "BST.h"
+#include "BTree.h"
+#include "CompactBST.h"
+#include "ConcurrentBST.h"
+#include "CData.h"
+#include "Normalizer.h"
+#include "PhraseWindow.h"
+#include "StopWords.h"
+#include "Timer.h"
+
+// index entry for each phrase hash seen (see addPhrase)
+typedef std::unordered_map<uint64_t, CData*> PhraseCache;
+
+/**
+ * Command line options for the concordance generator.
+ */
+struct KwicOptions
+{
+   std::vector<std::string> files; // corpus file names
+   int threads = 1; // number of threads that build the index (-j)
+   int printThreads = 1; // number of threads that format the output (-p)
+   int phrase = 1; // number of words in each key word (-n)
+   std::string index = "bst"; // layout of a single threaded index (-i)
+   int sample = 0; // most contexts kept per key word, 0 for all (-k)
+   bool stem = false; // group key words by their stem (-S)
+   std::vector<std::string> excludeFiles; // more words to exclude (-x)
+   bool prefetch = false; // read words ahead on a separate thread (-a)
+   bool timing = false; // print index and print times to cerr (-t)
+   bool compress = false; // store contexts as posting lists (-c)
+   bool stats = false; // print index size statistics to cerr (-s)
+   std::string socket = ""; // answer queries on this socket (-d)
+   int serverThreads = 4; // number of threads that answer queries (-w)
+};
 
 /**
  * stripPunctuation
@@ -33,14 +68,149 @@ bool isANum(std::string str);
 /**
  * handleArgs
  * Process the command line arguements.
- * If number of args != 2, print error message.
- * @return file name (the command line argument)
+ * Print a usage message if no corpus file is given or an option is invalid.
+ * @param opts options and corpus file names from the command line
+ * @return true if the arguments are valid, otherwise false
+ */
+bool handleArgs(int argc, char *argv[], KwicOptions &opts);
+
+/**
+ * indexAndPrint
+ * Add the key words and context strings of all the corpus files to the
+ * index on this thread, then print the concordance, or answer queries
+ * if a socket was given with -d.
+ * Calls: indexFile, serveIndex
+ * @param kwic empty index of concordance words and context strings
+ * @param opts command line options
+ * @param stopw stop words to exclude from the index
+ * @param timer times the index and print phases
+ * @return 0, or 1 if a file could not be read
+ */
+template <class Index>
+int indexAndPrint(Index &kwic, const KwicOptions &opts,
+                  const StopWords &stopw, Timer &timer);
+
+/**
+ * serveIndex
+ * Answer concordance queries on the socket given with -d, on a pool of
+ * opts.serverThreads threads, until a client sends SHUTDOWN.
+ * A query word is matched in lower case against the key words. With -S, a
+ * WORD query is stemmed like the key words; a PREFIX query is matched
+ * against the stems as it is.
+ * @param kwic index of concordance words and context strings
+ * @param leftWidth length of the longest before context string
+ * @param opts command line options
+ * @return 0, or 1 if the socket could not be created
+ */
+template <class Index>
+int serveIndex(const Index &kwic, int leftWidth, const KwicOptions &opts);
+
+/**
+ * indexFile
+ * Add the key words and context strings of one corpus file to the index.
+ * If tokens is not null, every word of the file is added to tokens and
+ * the index keeps the position of each key word instead of its context
+ * strings.
+ * Calls: addEntry
+ * @param fileName corpus file name
+ * @param opts command line options
+ * @param stopw stop words to exclude from the index
+ * @param kwic index of concordance words and context strings
+ * @param tokens corpus words for compressed posting lists, or nullptr
+ * @param normalizer normalization stage for key words, or nullptr; kept
+ *   from file to file by the calling thread, so its memo is reused
+ * @return length of the longest before context string,
+ *   or -1 if the file could not be read
+ */
+template <class Index>
+int indexFile(const std::string &fileName, const KwicOptions &opts,
+              const StopWords &stopw, Index &kwic,
+              TokenStore *tokens, Normalizer *normalizer);
+
+/**
+ * printStemStats
+ * Print the number of words stemmed by one thread, and how many of them
+ * were distinct, to cerr.
+ * @param memo memoized stemmer of the thread
+ */
+void printStemStats(const MemoNormalizer &memo);
+
+/**
+ * printStats
+ * Print the number of key words and occurrences in the index, and the
+ * bytes used for the contexts, to cerr.
+ * @param kwic index of concordance words and context strings
+ * @param tokens corpus words for compressed posting lists, or nullptr
+ */
+template <class Index>
+void printStats(const Index &kwic, const TokenStore *tokens);
+
+/**
+ * indexConcurrent
+ * Add the key words and context strings of all the corpus files to a
+ * shared index, using opts.threads threads. Each thread takes the next
+ * unread file until all files are read, with its own memoized stemmer.
+ * The order of the contexts for a key word that occurs in more than one
+ * file depends on the thread scheduling.
+ * Calls: indexFile
+ * @param opts command line options
+ * @param stopw stop words to exclude from the index
+ * @param kwic index of concordance words and context strings
+ * @return length of the longest before context string,
+ *   or -1 if any file could not be read
+ */
+int indexConcurrent(const KwicOptions &opts, const StopWords &stopw,
+                    ConcurrentBST<CData> &kwic);
+
+/**
+ * pushWord
+ * Add the next word of the corpus to the phrase window, with its key word
+ * form and whether it is a number or a stop word.
+ * @param window phrase window
+ * @param wordRaw the word, as read from the corpus
+ * @param stopw stop words
+ * @param normalizer normalization stage for key words, or nullptr
+ */
+void pushWord(PhraseWindow &window, const std::string &wordRaw,
+              const StopWords &stopw, Normalizer *normalizer);
+
+/**
+ * addPhrase
+ * Add the phrase in the window and its context strings to the index.
+ * A phrase seen before is found by the rolling hash of the window, and
+ * updated without building the phrase string or searching the index.
+ * Calls: addEntry
+ * @param kwic index of concordance words and context strings
+ * @param window phrase window, isValid() is true
+ * @param cache index entry for each phrase hash seen
+ * @param din context strings, width and position; keyWord is set here
+ */
+template <class Index>
+void addPhrase(Index &kwic, const PhraseWindow &window, PhraseCache &cache,
+               DataIn &din);
+
+/**
+ * addEntry
+ * Add a key word and its context strings to the index.
+ * Insert a new CData if the key word is not in the index,
+ * otherwise update the existing CData.
+ * @param kwic index of concordance words and context strings
+ * @param din key word, context strings and width
+ * @return pointer to the CData for the key word, if the caller may update
+ *   it directly later, otherwise nullptr
  */
-std::string handleArgs(int argc, char *argv[]);
+template <class Index>
+CData* addEntry(Index &kwic, DataIn &din);
+CData* addEntry(ConcurrentBST<CData> &kwic, DataIn &din);
 
 /**
  * loadStopWords
- * Load the stop words in stopwords.txt into a BST<string>.
- * If file not found, leave the BST empty.
+ * Load the stop words in stopwords.txt, and the words in each exclusion
+ * list given with -x.
+ * If stopwords.txt is not found, it is skipped.
+ * Print an error message to cerr if an exclusion list is not found.
+ * @param stopw stop words and other excluded words
+ * @param opts command line options
+ * @return false if an exclusion list could not be read, otherwise true
  */
-void loadStopWords(BST<std::string> &killw);
\ No newline at end of file
+bool loadStopWords(StopWords &stopw, const KwicOptions &opts);
\ No newline at end of file
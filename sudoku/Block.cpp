@@ -3,38 +3,41 @@
  * Thurman Gillespy
  * 11/2/17
  * 
- * class Block
- * A helper class for class Puzzle.
- * A 'block' is a 3x3 square subregion of a Sudoko puzzle.
+ * class BasicBlock
+ * A helper class for class BasicPuzzle.
+ * A 'block' is a BOX x BOX square subregion of a Sudoko puzzle: 3x3 in
+ * the usual 9x9 puzzle (class Block).
  * This class determines if the Block region is 'valid' per 
  * Soduko rules.
  */
 
 #include <cassert>
 #include "Block.h"
-#include "Square.h"
 
 /**
  * isValid
- * Determine if the 3x3 Block region is valid per Soduko rules.
- * There can be no more than 1 instance of the digits [1...9].
+ * Determine if the Block region is valid per Soduko rules.
+ * There can be no more than 1 instance of the digits [1...9] (or
+ * 1 - PUZZLE_DIM on a larger board).
  * Multiple 0s are allowed (represent empty squares).
- * @return true: no more than one digit 1 - 9;
- *   false: more than one digit 1 - 9.
+ * @param board the Puzzle board, one square value per byte
+ * @return true: no more than one of each digit;
+ *   false: more than one of a digit.
  */
-bool Block::isValid(Square& pos)
+template <int BOX>
+bool BasicBlock<BOX>::isValid(const unsigned char* board) const
 {
-   Square* initPos = &pos;
-   Square* curPos = initPos;
+   const unsigned char* initPos = board + position;
+   const unsigned char* curPos = initPos;
    // array for determining how many of each digit
-   int nums[NUM_DIGITS] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+   int nums[NUM_DIGITS] = {};
 
    for (int i = 0; i < BLOCK_DIM; i++)
    {
       for (int j = 0; j < BLOCK_DIM; j++)
       {
-         int curValue = curPos->getValue();
-         assert(curValue >= 0 && curValue <= 9);
+         int curValue = *curPos;
+         assert(curValue >= 0 && curValue <= PUZZLE_DIM);
          nums[curValue]++;
          curPos++;
       }
@@ -53,4 +56,10 @@ bool Block::isValid(Square& pos)
    // if the numDups < 2, the block is valid and return true
    // else return false
    return (numDups < 2) ? true : false;
-}
\ No newline at end of file
+}
+
+// the board sizes BasicPuzzle is built for: 4x4, 9x9, 16x16 and 25x25
+template class BasicBlock<2>;
+template class BasicBlock<3>;
+template class BasicBlock<4>;
+template class BasicBlock<5>;
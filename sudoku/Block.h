@@ -3,54 +3,50 @@
  * Thurman Gillespy
  * 11/2/17
  * 
- * class Block
- * A helper class for class Puzzle.
- * A 'block' is a 3x3 square subregion of a Sudoko puzzle.
+ * class BasicBlock
+ * A helper class for class BasicPuzzle.
+ * A 'block' is a BOX x BOX square subregion of a Sudoko puzzle: 3x3 in
+ * the usual 9x9 puzzle (class Block).
  * This class determines if the Block region is 'valid' per 
  * Soduko rules.
  */
 
 #pragma once
 
-class Square;// forward declaration
-
-class Block
+template <int BOX>
+class BasicBlock
 {
-   static const int BLOCK_DIM = 3;
-   static const int PUZZLE_DIM = 9;
-   static const int NUM_DIGITS = 10;
+   static const int BLOCK_DIM = BOX;
+   static const int PUZZLE_DIM = BOX * BOX;
+   static const int NUM_DIGITS = PUZZLE_DIM + 1;
 
 public:
    /**
     * single parameter constructor
     * Set position value.
+    * @param corner offset of the upper left corner of the Block in the
+    *   Puzzle board
     */
-   Block(Square& square) : position(square) {}
+   explicit BasicBlock(int corner) : position(corner) {}
 
     /**
      * isValid
-     * Determine if the 3x3 Block region is valid per Soduko rules.
-     * There can be no more than 1 instance of the digits [1...9].
+     * Determine if the Block region is valid per Soduko rules.
+     * There can be no more than 1 instance of the digits [1...9] (or
+     * 1 - PUZZLE_DIM on a larger board).
      * Multiple 0s are allowed (represent empty squares).
-     * @return true: no more than one digit 1 - 9;
-     *   false: more than one digit 1 - 9.
+     * @param board the Puzzle board, one square value per byte
+     * @return true: no more than one of each digit;
+     *   false: more than one of a digit.
      */
-   bool isValid() const { return isValid(this->position); }
+   bool isValid(const unsigned char* board) const;
 
 
 private:
-  // Reference to the Square in the Puzzle board that is
+  // Offset of the Square in the Puzzle board that is
   // the upper left corner of the Block.
-  Square &position;
+  int position;
+};
 
-  /**
-     * isValid
-     * Determine if the 3x3 Block region is valid per Soduko rules.
-     * There can be no more than 1 instance of the numbers [1...9] in block.
-     * Multiple 0s are allowed (represent empty squares).
-     * @param square - reference to upper left corner Square
-     * @return true: no duplicates in Block; 
-     *   false: duplicates in Block
-     */
-  static bool isValid(Square &square);
-};
\ No newline at end of file
+// the 3x3 Block of a 9x9 Puzzle
+typedef BasicBlock<3> Block;
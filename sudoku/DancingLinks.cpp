@@ -0,0 +1,272 @@
+/**
+ * DancingLinks.cpp
+ *
+ * Sudoku solver using Knuth's Algorithm X with dancing links (DLX).
+ * A Sudoku is an exact cover problem: choose one of 729 rows (a digit in
+ * a square) for each of 324 columns (each square has a digit, and each
+ * row, column and block has each digit once).
+ */
+
+#include "DancingLinks.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * solve
+ * Solve a Puzzle read by operator>>, and set its empty Squares to
+ * the solution.
+ * The given digits are chosen first; a given that conflicts with another
+ * means the Puzzle can't be solved.
+ * @param p Puzzle to solve
+ * @return true: Puzzle was solved; false: could not be solved (the
+ *   Puzzle is not changed)
+ */
+template <int BOX>
+bool BasicDancingLinks<BOX>::solve(BasicPuzzle<BOX>& p)
+{
+   return countSolutions(p, 1) == 1;
+}
+
+/**
+ * countSolutions
+ * Count the exact covers of a Puzzle read by operator>>, up to a
+ * limit, and set its empty Squares to the first one.
+ * The search goes on past each cover, until it has found limit of them
+ * or tried every row; nodes and guesses count the whole search.
+ * @param p Puzzle to solve
+ * @param limit most solutions to count, at least 1
+ * @return number of solutions found, 0 - limit (the Puzzle is not
+ *   changed if 0)
+ */
+template <int BOX>
+int BasicDancingLinks<BOX>::countSolutions(BasicPuzzle<BOX>& p, int limit)
+{
+   SUDOKU_STAT(seconds = 0; StatTimer timer(&seconds));
+   build();
+   depth = 0;
+   nodes = 0;
+   guesses = 0;
+   this->limit = limit;
+   solutions = 0;
+   SUDOKU_STAT(backtracks = 0; maxDepth = 0);
+
+   for (int pos = 0; pos < PUZZLE_SIZE; pos++)
+   {
+      int value = p.get(pos).getValue();
+      int r = pos * PUZZLE_DIM + value - 1;
+      if (value != 0 && !choose(1 + COLUMNS + 4 * r))
+         return 0;
+   }
+   int givens = depth;
+   SUDOKU_STAT(this->givens = givens);
+
+   search();
+   if (solutions == 0)
+      return 0;
+
+   // the rows chosen by the search are the digits of the empty squares
+   for (int i = givens; i < PUZZLE_SIZE; i++)
+      p.set(first[i] / PUZZLE_DIM, first[i] % PUZZLE_DIM + 1);
+   return solutions;
+}
+
+/**
+ * build
+ * Link the rows and columns of an empty Sudoku board.
+ * Row pos * PUZZLE_DIM + (value - 1) has a node in the columns for: square pos
+ * has a digit; its row has value; its column has value; its block has
+ * value.
+ */
+template <int BOX>
+void BasicDancingLinks<BOX>::build()
+{
+   // header list: root, then columns 1 - COLUMNS, in a circle
+   for (int c = 0; c <= COLUMNS; c++)
+   {
+      left[c] = c - 1;
+      right[c] = c + 1;
+      up[c] = down[c] = c;
+      column[c] = c;
+      count[c] = 0;
+   }
+   left[0] = COLUMNS;
+   right[COLUMNS] = 0;
+
+   int n = COLUMNS + 1;
+   for (int r = 0; r < ROWS; r++)
+   {
+      int pos = r / PUZZLE_DIM;
+      int digit = r % PUZZLE_DIM;
+      int rowIndex = pos / PUZZLE_DIM;
+      int colIndex = pos % PUZZLE_DIM;
+      int block = rowIndex / BLOCK_DIM * BLOCK_DIM + colIndex / BLOCK_DIM;
+      int columns[4] = {pos,
+                        PUZZLE_SIZE + rowIndex * PUZZLE_DIM + digit,
+                        2 * PUZZLE_SIZE + colIndex * PUZZLE_DIM + digit,
+                        3 * PUZZLE_SIZE + block * PUZZLE_DIM + digit};
+
+      int first = n;
+      for (int k = 0; k < 4; k++, n++)
+      {
+         int c = columns[k] + 1;
+         // append to the bottom of column c
+         column[n] = c;
+         row[n] = r;
+         up[n] = up[c];
+         down[n] = c;
+         down[up[c]] = n;
+         up[c] = n;
+         count[c]++;
+         // and to the circle of the row
+         left[n] = (k == 0) ? first + 3 : n - 1;
+         right[n] = (k == 3) ? first : n + 1;
+      }
+   }
+}
+
+/**
+ * choose
+ * Remove a row from the matrix, as a given digit or a search step.
+ * @param r first node of the row
+ * @return false if one of its columns was already covered (the digit
+ *   conflicts with another), otherwise true
+ */
+template <int BOX>
+bool BasicDancingLinks<BOX>::choose(int r)
+{
+   int j = r;
+   do
+   {
+      int c = column[j];
+      if (right[left[c]] != c)
+         return false;
+      cover(c);
+      j = right[j];
+   } while (j != r);
+
+   solution[depth++] = row[r];
+   return true;
+}
+
+/**
+ * cover
+ * Unlink a column header, and unlink every row of the column from
+ * its other columns.
+ * @param c column header node
+ */
+template <int BOX>
+void BasicDancingLinks<BOX>::cover(int c)
+{
+   left[right[c]] = left[c];
+   right[left[c]] = right[c];
+   for (int i = down[c]; i != c; i = down[i])
+   {
+      for (int j = right[i]; j != i; j = right[j])
+      {
+         up[down[j]] = up[j];
+         down[up[j]] = down[j];
+         count[column[j]]--;
+      }
+   }
+}
+
+/**
+ * uncover
+ * Undo cover(c): relink in the reverse order.
+ * @param c column header node
+ */
+template <int BOX>
+void BasicDancingLinks<BOX>::uncover(int c)
+{
+   for (int i = up[c]; i != c; i = up[i])
+   {
+      for (int j = left[i]; j != i; j = left[j])
+      {
+         count[column[j]]++;
+         up[down[j]] = j;
+         down[up[j]] = j;
+      }
+   }
+   left[right[c]] = c;
+   right[left[c]] = c;
+}
+
+/**
+ * search
+ * Algorithm X: cover the columns left, one row at a time, and count
+ * each exact cover found; the rows of the first are kept in first.
+ * Branch on the column with the fewest rows; a column with none is a
+ * dead end. The matrix is left as it is once limit covers are found.
+ * Recursive method.
+ * @return true: limit solutions were found; false: fewer
+ */
+template <int BOX>
+bool BasicDancingLinks<BOX>::search()
+{
+   SUDOKU_STAT(maxDepth = max(maxDepth, depth - givens));
+   if (right[0] == 0)
+   {
+      // every column covered: depth is PUZZLE_SIZE
+      if (solutions++ == 0)
+         copy(solution, solution + depth, first);
+      return solutions >= limit;
+   }
+
+   int c = right[0];
+   for (int j = right[c]; j != 0 && count[c] > 1; j = right[j])
+   {
+      if (count[j] < count[c])
+         c = j;
+   }
+   if (count[c] == 0)
+      return false;
+
+   bool guess = count[c] > 1;
+   cover(c);
+   for (int r = down[c]; r != c; r = down[r])
+   {
+      nodes++;
+      if (guess) guesses++;
+      solution[depth++] = row[r];
+      for (int j = right[r]; j != r; j = right[j])
+         cover(column[j]);
+
+      if (search())
+         return true;
+
+      for (int j = left[r]; j != r; j = left[j])
+         uncover(column[j]);
+      depth--;
+      SUDOKU_STAT(backtracks++);
+   }
+   uncover(c);
+   return false;
+}
+
+/**
+ * getStats
+ * Get what the last solve() or countSolutions() did. Forced digits and
+ * propagation passes are not counted: DLX finds singles by branching on
+ * a column with one row.
+ * @return the counters; without SUDOKU_STATS, only nodes and guesses
+ */
+template <int BOX>
+SolveStats BasicDancingLinks<BOX>::getStats() const
+{
+   SolveStats stats;
+   stats.nodes = nodes;
+   stats.guesses = guesses;
+#ifdef SUDOKU_STATS
+   stats.backtracks = backtracks;
+   stats.maxDepth = maxDepth;
+   stats.seconds = seconds;
+#endif
+   return stats;
+}
+
+// the board sizes of BasicPuzzle: 4x4, 9x9, 16x16 and 25x25
+template class BasicDancingLinks<2>;
+template class BasicDancingLinks<3>;
+template class BasicDancingLinks<4>;
+template class BasicDancingLinks<5>;
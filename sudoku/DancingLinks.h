@@ -0,0 +1,147 @@
+/**
+ * DancingLinks.h
+ *
+ * class BasicDancingLinks
+ * Sudoku solver using Knuth's Algorithm X with dancing links (DLX).
+ * A Sudoku is an exact cover problem: choose one of 729 rows (a digit in
+ * a square) for each of 324 columns (each square has a digit, and each
+ * row, column and block has each digit once). The rows are doubly linked
+ * lists of nodes, 4 per row, one in each of its columns; covering a
+ * column unlinks it and every row that meets it, and uncovering puts
+ * them back in reverse order. The search branches on the column with the
+ * fewest rows left.
+ * The links are kept in arrays indexed by node, and rebuilt for each
+ * Puzzle.
+ * Like BasicPuzzle, the board size is a template parameter (the counts
+ * above are for 9x9, class DancingLinks); for 25x25 the arrays take
+ * about 1.6 MB, so allocate that one on the heap.
+ * Built with -DSUDOKU_STATS, it also counts backtracks and depth, and
+ * times each solve (see getStats).
+ */
+
+#pragma once
+
+#include "Puzzle.h"
+
+template <int BOX>
+class BasicDancingLinks
+{
+   static const int BLOCK_DIM = BOX;
+   static const int PUZZLE_DIM = BOX * BOX;
+   static const int PUZZLE_SIZE = PUZZLE_DIM * PUZZLE_DIM;
+   static const int COLUMNS = 4 * PUZZLE_SIZE; // 324 constraints for 9x9
+   static const int ROWS = PUZZLE_SIZE * PUZZLE_DIM; // 729 choices
+   // node 0 is the root, nodes 1 - COLUMNS the column headers, then
+   // 4 nodes for each row
+   static const int NODES = 1 + COLUMNS + 4 * ROWS;
+
+public:
+   /**
+    * solve
+    * Solve a Puzzle read by operator>>, and set its empty Squares to
+    * the solution.
+    * @param p Puzzle to solve
+    * @return true: Puzzle was solved; false: could not be solved (the
+    *   Puzzle is not changed)
+    */
+   bool solve(BasicPuzzle<BOX>& p);
+
+   /**
+    * countSolutions
+    * Count the exact covers of a Puzzle read by operator>>, up to a
+    * limit, and set its empty Squares to the first one.
+    * @param p Puzzle to solve
+    * @param limit most solutions to count, at least 1
+    * @return number of solutions found, 0 - limit
+    */
+   int countSolutions(BasicPuzzle<BOX>& p, int limit);
+
+   /**
+    * getNodes
+    * Get the number of rows tried by the last solve() (search tree nodes).
+    * @return number of nodes
+    */
+   long getNodes() const { return this->nodes; }
+
+   /**
+    * getGuesses
+    * Get the number of rows tried by the last solve() in a column that
+    * had more than one row left.
+    * @return number of guesses
+    */
+   long getGuesses() const { return this->guesses; }
+
+   /**
+    * getStats
+    * Get what the last solve() or countSolutions() did. Forced digits
+    * and propagation passes are not counted: DLX finds singles by
+    * branching on a column with one row.
+    * @return the counters; without SUDOKU_STATS, only nodes and guesses
+    */
+   SolveStats getStats() const;
+
+private:
+   // links of each node: left, right, up, down, and its column header
+   int left[NODES];
+   int right[NODES];
+   int up[NODES];
+   int down[NODES];
+   int column[NODES];
+   int row[NODES]; // row index of a node (pos * PUZZLE_DIM + digit - 1)
+   int count[COLUMNS + 1]; // number of rows in each column
+   int solution[PUZZLE_SIZE]; // rows chosen by search, in order
+   int depth = 0; // number of rows in solution
+   int first[PUZZLE_SIZE]; // solution when the first cover was found
+   int limit = 1; // search() stops at this many solutions
+   int solutions = 0; // exact covers found by search()
+   long nodes = 0; // rows tried by search()
+   long guesses = 0; // rows tried in a column with 2 or more rows
+#ifdef SUDOKU_STATS
+   int givens = 0; // rows chosen for the given digits
+   long backtracks = 0; // rows whose subtree had no cover
+   int maxDepth = 0; // most rows chosen by search() on a path
+   double seconds = 0; // time of the last solve()
+#endif
+
+   /**
+    * build
+    * Link the rows and columns of an empty Sudoku board.
+    */
+   void build();
+
+   /**
+    * choose
+    * Remove a row from the matrix, as a given digit or a search step.
+    * @param r first node of the row
+    * @return false if one of its columns was already covered (the digit
+    *   conflicts with another), otherwise true
+    */
+   bool choose(int r);
+
+   /**
+    * cover
+    * Unlink a column header, and unlink every row of the column from
+    * its other columns.
+    * @param c column header node
+    */
+   void cover(int c);
+
+   /**
+    * uncover
+    * Undo cover(c).
+    * @param c column header node
+    */
+   void uncover(int c);
+
+   /**
+    * search
+    * Algorithm X: cover the columns left, one row at a time, and count
+    * each exact cover found.
+    * Recursive method.
+    * @return true: limit solutions were found; false: fewer
+    */
+   bool search();
+};
+
+// the usual 9x9 Sudoku
+typedef BasicDancingLinks<3> DancingLinks;
@@ -0,0 +1,277 @@
+/**
+ * Generator.cpp
+ *
+ * Sudoku puzzle generator: random full grids, clues taken out while the
+ * solution stays unique, and grades by the techniques the solver needs.
+ */
+
+#include "Generator.h"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace std;
+
+/**
+ * generate
+ * Make puzzle number n of the seed: the first one of the wanted grade,
+ * out of MAX_TRIES. The random numbers are seeded with the seed and n,
+ * so the puzzle does not depend on the thread or the order.
+ * @param n puzzle number
+ * @param g set to the puzzle
+ * @return true: a puzzle of the wanted grade was made; false: none
+ *   in MAX_TRIES tries
+ */
+template <int BOX>
+bool BasicGenerator<BOX>::generate(uint64_t n, Generated& g) const
+{
+   seed_seq sequence{(uint32_t) seed, (uint32_t) (seed >> 32),
+                     (uint32_t) n, (uint32_t) (n >> 32)};
+   mt19937_64 random(sequence);
+
+   for (int tries = 0; tries < MAX_TRIES; tries++)
+   {
+      g.solution = fillGrid(random);
+      g.puzzle = removeClues(g.solution, random);
+      g.grade = grade(g.puzzle, g.guesses);
+      if (wanted == ANY || g.grade == wanted)
+      {
+         g.clues = (int) (PUZZLE_SIZE - count(g.puzzle.begin(),
+                                              g.puzzle.end(), '0'));
+         return true;
+      }
+   }
+   return false;
+}
+
+/**
+ * grade
+ * Grade a puzzle with a unique solution: solve it with naked singles
+ * alone, then with MRV and naked and hidden singles; a solve that takes
+ * no guess needs only those techniques.
+ * @param puzzle the puzzle line (see Puzzle::read)
+ * @param guesses set to the guesses to solve it with MRV and
+ *   propagation
+ * @return the grade; FIENDISH if the line is not a puzzle
+ */
+template <int BOX>
+typename BasicGenerator<BOX>::Grade
+BasicGenerator<BOX>::grade(const string& puzzle, long& guesses) const
+{
+   typedef BasicPuzzle<BOX> Puzzle;
+
+   Puzzle naked;
+   naked.setPropagate(true);
+   naked.setHiddenSingles(false);
+   if (!naked.read(puzzle))
+   {
+      guesses = 0;
+      return FIENDISH;
+   }
+   Puzzle p = naked;
+   p.setMRV(true);
+   p.setHiddenSingles(true);
+
+   typename Puzzle::Status status = p.search(budget);
+   guesses = p.getGuesses();
+   if (status != Puzzle::SOLVED || guesses > HARD_GUESSES)
+      return FIENDISH;
+   if (guesses > 0)
+      return HARD;
+   if (naked.search(budget) == Puzzle::SOLVED && naked.getGuesses() == 0)
+      return EASY;
+   return MEDIUM;
+}
+
+/**
+ * gradeName
+ * @param grade a grade
+ * @return its name in lower case, "any" for ANY
+ */
+template <int BOX>
+const char* BasicGenerator<BOX>::gradeName(Grade grade)
+{
+   switch (grade)
+   {
+   case EASY:
+      return "easy";
+   case MEDIUM:
+      return "medium";
+   case HARD:
+      return "hard";
+   case FIENDISH:
+      return "fiendish";
+   default:
+      return "any";
+   }
+}
+
+/**
+ * gradeOf
+ * @param name name of a grade, as gradeName returns it
+ * @return the grade, or GRADES if there is none of that name
+ */
+template <int BOX>
+typename BasicGenerator<BOX>::Grade
+BasicGenerator<BOX>::gradeOf(const string& name)
+{
+   for (int g = ANY; g < GRADES; g++)
+   {
+      if (name == gradeName((Grade) g))
+         return (Grade) g;
+   }
+   return GRADES;
+}
+
+/**
+ * fillGrid
+ * Make a random full grid: fill the blocks on the diagonal with random
+ * permutations of the digits, solve the rest with MRV and propagation,
+ * and shuffle it. Blocks on the diagonal share no row or column, so any
+ * such start can be completed; one whose search runs out of nodes is
+ * thrown away.
+ * @param random random number generator
+ * @return the PUZZLE_SIZE digits of the grid
+ */
+template <int BOX>
+string BasicGenerator<BOX>::fillGrid(mt19937_64& random) const
+{
+   typedef BasicPuzzle<BOX> Puzzle;
+
+   while (true)
+   {
+      string start(PUZZLE_SIZE, '0');
+      vector<int> digits(PUZZLE_DIM);
+      iota(digits.begin(), digits.end(), 1);
+      for (int b = 0; b < BLOCK_DIM; b++)
+      {
+         std::shuffle(digits.begin(), digits.end(), random);
+         for (int k = 0; k < PUZZLE_DIM; k++)
+         {
+            int row = b * BLOCK_DIM + k / BLOCK_DIM;
+            int col = b * BLOCK_DIM + k % BLOCK_DIM;
+            start[row * PUZZLE_DIM + col] = Puzzle::symbol(digits[k]);
+         }
+      }
+
+      Puzzle p;
+      p.read(start);
+      p.setMRV(true);
+      p.setPropagate(true);
+      if (p.search(budget) != Puzzle::SOLVED)
+         continue;
+
+      string grid(PUZZLE_SIZE, '0');
+      for (int pos = 0; pos < PUZZLE_SIZE; pos++)
+         grid[pos] = Puzzle::symbol(p.get(pos).getValue());
+      shuffle(grid, random);
+      return grid;
+   }
+}
+
+/**
+ * shuffle
+ * Shuffle the bands (rows of blocks), the rows in each band, the stacks
+ * (columns of blocks) and the columns in each stack of a grid. Each
+ * keeps it a valid grid.
+ * @param grid PUZZLE_SIZE digits
+ * @param random random number generator
+ */
+template <int BOX>
+void BasicGenerator<BOX>::shuffle(string& grid, mt19937_64& random)
+{
+   // new row and column k are old row[k] and col[k]
+   vector<int> band(BLOCK_DIM);
+   vector<int> row(PUZZLE_DIM);
+   vector<int> col(PUZZLE_DIM);
+   for (int dir = 0; dir < 2; dir++)
+   {
+      vector<int>& order = dir == 0 ? row : col;
+      iota(band.begin(), band.end(), 0);
+      std::shuffle(band.begin(), band.end(), random);
+      for (int b = 0; b < BLOCK_DIM; b++)
+      {
+         auto first = order.begin() + b * BLOCK_DIM;
+         iota(first, first + BLOCK_DIM, band[b] * BLOCK_DIM);
+         std::shuffle(first, first + BLOCK_DIM, random);
+      }
+   }
+
+   string old = grid;
+   for (int r = 0; r < PUZZLE_DIM; r++)
+   {
+      for (int c = 0; c < PUZZLE_DIM; c++)
+         grid[r * PUZZLE_DIM + c] = old[row[r] * PUZZLE_DIM + col[c]];
+   }
+}
+
+/**
+ * removeClues
+ * Take the clues out of a full grid in random order, keeping each one
+ * whose removal would leave more than one solution. Removing clues
+ * never makes a solution unique again, so the puzzle is minimal: no
+ * clue left can be taken out (unless its check ran out of nodes).
+ * @param grid PUZZLE_SIZE digits, a valid full grid
+ * @param random random number generator
+ * @return the puzzle
+ */
+template <int BOX>
+string BasicGenerator<BOX>::removeClues(const string& grid,
+                                        mt19937_64& random) const
+{
+   string puzzle = grid;
+   vector<int> order(PUZZLE_SIZE);
+   iota(order.begin(), order.end(), 0);
+   std::shuffle(order.begin(), order.end(), random);
+
+   for (int i = 0; i < PUZZLE_SIZE; i++)
+   {
+      int pos = order[i];
+      int value = BasicPuzzle<BOX>::valueOf(grid[pos]);
+      puzzle[pos] = '0';
+      if (!isForced(puzzle, pos, value))
+         puzzle[pos] = grid[pos];
+   }
+   return puzzle;
+}
+
+/**
+ * isForced
+ * Check that an empty square of a puzzle can only hold one digit, by
+ * trying each other legal digit there: the puzzle is unique without the
+ * clue if none of them can be solved. That is cheaper than counting to
+ * two solutions, which also searches the subtree of the solution. The
+ * puzzle is read once, and each digit is tried on a copy.
+ * @param puzzle PUZZLE_SIZE digits, with a unique solution if the square
+ *   were given
+ * @param pos the square, empty
+ * @param value its digit in the solution
+ * @return true: every other digit there leaves the puzzle with no
+ *   solution; false: one has a solution, or a search ran out of nodes
+ */
+template <int BOX>
+bool BasicGenerator<BOX>::isForced(const string& puzzle, int pos,
+                                   int value) const
+{
+   typedef BasicPuzzle<BOX> Puzzle;
+
+   Puzzle empty;
+   empty.read(puzzle);
+   empty.setMRV(true);
+   empty.setPropagate(true);
+   for (int other = 1; other <= PUZZLE_DIM; other++)
+   {
+      Puzzle p = empty;
+      if (other == value || !p.set(pos, other))
+         continue;
+      if (p.search(budget) != Puzzle::UNSOLVABLE)
+         return false;
+   }
+   return true;
+}
+
+// the board sizes of BasicPuzzle: 4x4, 9x9, 16x16 and 25x25
+template class BasicGenerator<2>;
+template class BasicGenerator<3>;
+template class BasicGenerator<4>;
+template class BasicGenerator<5>;
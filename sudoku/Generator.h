@@ -0,0 +1,170 @@
+/**
+ * Generator.h
+ *
+ * class BasicGenerator
+ * Makes Sudoku puzzles with a unique solution, and grades them.
+ * A puzzle starts as a random full grid: the blocks on the diagonal
+ * (which share no row or column) are filled with random permutations,
+ * the rest is solved by the Puzzle search, and the bands, stacks, rows
+ * and columns are shuffled. Clues are then taken out one at a time, in
+ * random order, and each is put back if the solution is no longer
+ * unique, so the puzzle is minimal.
+ * A puzzle is graded by what the solver needs to solve it: naked singles
+ * alone (EASY), naked and hidden singles (MEDIUM), or guesses on top of
+ * both (HARD, or FIENDISH past HARD_GUESSES).
+ * Puzzle number n of a seed is always the same puzzle, so puzzles can be
+ * made on any number of threads, in any order; a BasicGenerator has no
+ * state that changes, and one can be shared by all the threads.
+ * Like BasicPuzzle, the board size is a template parameter, and
+ * Generator makes the usual 9x9 puzzles.
+ */
+
+#pragma once
+
+#include "Puzzle.h"
+#include <cstdint>
+#include <random>
+#include <string>
+
+template <int BOX>
+class BasicGenerator
+{
+   static const int BLOCK_DIM = BOX;
+   static const int PUZZLE_DIM = BOX * BOX;
+   static const int PUZZLE_SIZE = PUZZLE_DIM * PUZZLE_DIM;
+   static const int MAX_TRIES = 1000; // puzzles made to find one grade
+   static const int HARD_GUESSES = 20; // most guesses of a HARD puzzle
+
+public:
+   /**
+    * Difficulty of a puzzle, easiest first.
+    */
+   enum Grade
+   {
+      ANY = -1, // for setGrade: keep every puzzle
+      EASY, // solved by naked singles
+      MEDIUM, // solved by naked and hidden singles
+      HARD, // needs 1 - HARD_GUESSES guesses with MRV and propagation
+      FIENDISH, // needs more, or the node budget ran out
+      GRADES // number of grades
+   };
+
+   /**
+    * A generated puzzle.
+    */
+   struct Generated
+   {
+      std::string puzzle; // PUZZLE_SIZE digits (see Puzzle::symbol), 0
+                          // for an empty square
+      std::string solution; // the digits of its solution
+      int clues = 0; // given squares
+      Grade grade = ANY;
+      long guesses = 0; // guesses to solve it with MRV and propagation
+   };
+
+   /**
+    * Constructor.
+    * @param seed seed of the random puzzles
+    */
+   explicit BasicGenerator(uint64_t seed) : seed(seed) {}
+
+   /**
+    * setGrade
+    * Keep only the puzzles of one grade.
+    * @param grade the grade, or ANY (the default) for every puzzle
+    */
+   void setGrade(Grade grade) { this->wanted = grade; }
+
+   /**
+    * setBudget
+    * Set the most nodes of each search made to fill a grid, check that a
+    * solution is unique, or grade a puzzle. A clue whose check runs out
+    * is kept.
+    * @param budget nodes, at least 1
+    */
+   void setBudget(long budget) { this->budget = budget; }
+
+   /**
+    * generate
+    * Make puzzle number n of the seed: the first one of the wanted
+    * grade, out of MAX_TRIES.
+    * @param n puzzle number
+    * @param g set to the puzzle
+    * @return true: a puzzle of the wanted grade was made; false: none
+    *   in MAX_TRIES tries
+    */
+   bool generate(uint64_t n, Generated& g) const;
+
+   /**
+    * grade
+    * Grade a puzzle with a unique solution.
+    * @param puzzle the puzzle line (see Puzzle::read)
+    * @param guesses set to the guesses to solve it with MRV and
+    *   propagation
+    * @return the grade; FIENDISH if the line is not a puzzle
+    */
+   Grade grade(const std::string& puzzle, long& guesses) const;
+
+   /**
+    * gradeName
+    * @param grade a grade
+    * @return its name in lower case, "any" for ANY
+    */
+   static const char* gradeName(Grade grade);
+
+   /**
+    * gradeOf
+    * @param name name of a grade, as gradeName returns it
+    * @return the grade, or GRADES if there is none of that name
+    */
+   static Grade gradeOf(const std::string& name);
+
+private:
+   uint64_t seed;
+   Grade wanted = ANY; // grade to keep
+   long budget = 100000; // most nodes of each search
+
+   /**
+    * fillGrid
+    * Make a random full grid.
+    * @param random random number generator
+    * @return the PUZZLE_SIZE digits of the grid
+    */
+   std::string fillGrid(std::mt19937_64& random) const;
+
+   /**
+    * shuffle
+    * Shuffle the bands (rows of blocks), the rows in each band, the
+    * stacks (columns of blocks) and the columns in each stack of a grid.
+    * Each keeps it a valid grid.
+    * @param grid PUZZLE_SIZE digits
+    * @param random random number generator
+    */
+   static void shuffle(std::string& grid, std::mt19937_64& random);
+
+   /**
+    * removeClues
+    * Take the clues out of a full grid in random order, keeping each
+    * one whose removal would leave more than one solution.
+    * @param grid PUZZLE_SIZE digits, a valid full grid
+    * @param random random number generator
+    * @return the puzzle
+    */
+   std::string removeClues(const std::string& grid,
+                           std::mt19937_64& random) const;
+
+   /**
+    * isForced
+    * Check that an empty square of a puzzle can only hold one digit.
+    * @param puzzle PUZZLE_SIZE digits, with a unique solution if the
+    *   square were given
+    * @param pos the square, empty
+    * @param value its digit in the solution
+    * @return true: every other digit there leaves the puzzle with no
+    *   solution; false: one has a solution, or a search ran out of nodes
+    */
+   bool isForced(const std::string& puzzle, int pos, int value) const;
+};
+
+// the usual 9x9 Sudoku
+typedef BasicGenerator<3> Generator;
@@ -4,75 +4,915 @@
  * 11/14/17
  * 
  * This class represents a Sudoku puzzle board.
- * The class contains a board array of Square objects, with
- * operations to add a value, erase a value, and check the validity of
- * a proposed digit in an empty square.
- * The puzzle is solved with a recursive backtracking algorithm.
+ * The class contains a packed board, a byte for each square's value and
+ * a bitmap of the fixed squares, with operations to add a value, erase a
+ * value, and check the validity of a proposed digit in an empty square.
+ * A Puzzle holds no pointers into itself, so it is trivially copyable:
+ * a copy is a plain memory copy of a few hundred bytes.
+ * The digits used in each row, column and block are kept as bitmasks,
+ * updated on each set and erase, so checking a proposed digit is O(1).
+ * The puzzle is solved with a recursive backtracking algorithm, which
+ * branches on the next empty square in scan order, or, with the minimum
+ * remaining values (MRV) heuristic, on the empty square with the fewest
+ * legal digits.
+ * With constraint propagation, each node of the search first fills every
+ * naked single (a square with one legal digit) and hidden single (a digit
+ * with one legal square in a row, column or block), until none are left.
+ * The squares it fills are kept on a trail, and erased on backtrack.
+ * search() is an iterative version of solve(), with an explicit stack
+ * of the squares branched on, which can stop after a number of nodes and
+ * be resumed later.
+ * A hard puzzle can also be solved on several threads: the top levels of
+ * the search tree are expanded into copies of the Puzzle, one for each
+ * subtree, which are searched at once until one finds a solution.
+ * The legal digits of every square can be counted at once, to pick the
+ * MRV square and find naked singles; built with AVX2 (-mavx2), a 9x9
+ * board does this with a vector kernel.
  */
 
 #include "Puzzle.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
+static_assert(is_trivially_copyable<Puzzle>::value,
+              "Puzzle copies must be plain memory copies");
+static_assert(is_trivially_copyable<BasicPuzzle<5> >::value,
+              "Puzzle copies must be plain memory copies");
+
+/**
+ * struct CandidateKernel
+ * Vector kernel of getCandidateCounts for a board size: none, except
+ * for 9x9 built with AVX2.
+ */
+template <int BOX>
+struct CandidateKernel
+{
+   static const bool AVAILABLE = false;
+
+   template <class Mask>
+   static int run(const unsigned char*, const Mask*, const Mask*,
+                  const Mask*, unsigned char*, uint64_t*) { return 0; }
+};
+
+#ifdef __AVX2__
+/**
+ * struct CandidateKernel<3>
+ * AVX2 kernel of getCandidateCounts for a 9x9 board.
+ * The 9 row, column and block masks are split into a low and a high
+ * byte each, so each half is a 16-byte table that one byte shuffle
+ * looks up for 32 squares at once: the squares 0 - 31, 32 - 63 and
+ * 49 - 80 (the last two overlap, so no load goes past the board).
+ * The legal digits are counted with a shuffle of a 4-bit popcount table.
+ */
+template <>
+struct CandidateKernel<3>
+{
+   static const bool AVAILABLE = true;
+
+   /**
+    * run
+    * Count the legal digits of every empty square of a 9x9 board.
+    * @param board the 81 square values
+    * @param rowMask, colMask, blockMask digits used in each unit
+    * @param counts set to the 81 counts, FILLED if not empty
+    * @param fewBits set to the empty squares with 0 or 1 legal digits
+    * @return the least count of an empty square, or FILLED if none empty
+    */
+   static int run(const unsigned char* board, const uint16_t* rowMask,
+                  const uint16_t* colMask, const uint16_t* blockMask,
+                  unsigned char* counts, uint64_t* fewBits)
+   {
+      // row, column and block of each square
+      static const unsigned char ROW_OF[81] = {
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+         2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+         4, 4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+         6, 6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+         8, 8, 8, 8, 8, 8, 8, 8, 8};
+      static const unsigned char COL_OF[81] = {
+         0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8,
+         0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8,
+         0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8,
+         0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8,
+         0, 1, 2, 3, 4, 5, 6, 7, 8};
+      static const unsigned char BLOCK_OF[81] = {
+         0, 0, 0, 1, 1, 1, 2, 2, 2, 0, 0, 0, 1, 1, 1, 2, 2, 2,
+         0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 5,
+         3, 3, 3, 4, 4, 4, 5, 5, 5, 3, 3, 3, 4, 4, 4, 5, 5, 5,
+         6, 6, 6, 7, 7, 7, 8, 8, 8, 6, 6, 6, 7, 7, 7, 8, 8, 8,
+         6, 6, 6, 7, 7, 7, 8, 8, 8};
+      const int START[3] = {0, 32, 49};
+
+      __m256i rowLo, rowHi, colLo, colHi, blockLo, blockHi;
+      split(rowMask, rowLo, rowHi);
+      split(colMask, colLo, colHi);
+      split(blockMask, blockLo, blockHi);
+      const __m256i popcount = _mm256_setr_epi8(
+         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+      const __m256i nibble = _mm256_set1_epi8(0x0F);
+      const __m256i one = _mm256_set1_epi8(1);
+      const __m256i zero = _mm256_setzero_si256();
+      __m256i least = _mm256_set1_epi8((char) 0xFF);
+      uint32_t few[3];
+
+      for (int c = 0; c < 3; c++)
+      {
+         int s = START[c];
+         __m256i row = load(ROW_OF + s);
+         __m256i col = load(COL_OF + s);
+         __m256i block = load(BLOCK_OF + s);
+         // digits used in the row, column or block of each square
+         __m256i usedLo = _mm256_or_si256(_mm256_or_si256(
+            _mm256_shuffle_epi8(rowLo, row), _mm256_shuffle_epi8(colLo, col)),
+            _mm256_shuffle_epi8(blockLo, block));
+         __m256i usedHi = _mm256_or_si256(_mm256_or_si256(
+            _mm256_shuffle_epi8(rowHi, row), _mm256_shuffle_epi8(colHi, col)),
+            _mm256_shuffle_epi8(blockHi, block));
+         // legal digits: 1 - 7 in the low byte, 8 - 9 in the high byte
+         __m256i lo = _mm256_andnot_si256(usedLo,
+                                          _mm256_set1_epi8((char) 0xFE));
+         __m256i hi = _mm256_andnot_si256(usedHi, _mm256_set1_epi8(0x03));
+         __m256i n = _mm256_add_epi8(_mm256_add_epi8(
+            _mm256_shuffle_epi8(popcount, _mm256_and_si256(lo, nibble)),
+            _mm256_shuffle_epi8(popcount, _mm256_and_si256(
+               _mm256_srli_epi16(lo, 4), nibble))),
+            _mm256_shuffle_epi8(popcount, hi));
+         // FILLED for a square that is not empty
+         __m256i empty = _mm256_cmpeq_epi8(load(board + s), zero);
+         n = _mm256_or_si256(n, _mm256_xor_si256(empty,
+                                                 _mm256_set1_epi8(-1)));
+         _mm256_storeu_si256((__m256i*) (counts + s), n);
+         few[c] = (uint32_t) _mm256_movemask_epi8(
+                     _mm256_cmpeq_epi8(_mm256_min_epu8(n, one), n));
+         least = _mm256_min_epu8(least, n);
+      }
+      // squares 0 - 63, then 64 - 80 from the last 17 of 49 - 80
+      fewBits[0] = few[0] | (uint64_t) few[1] << 32;
+      fewBits[1] = few[2] >> 15;
+
+      __m128i m = _mm_min_epu8(_mm256_castsi256_si128(least),
+                               _mm256_extracti128_si256(least, 1));
+      m = _mm_min_epu8(m, _mm_srli_si128(m, 8));
+      m = _mm_min_epu8(m, _mm_srli_si128(m, 4));
+      m = _mm_min_epu8(m, _mm_srli_si128(m, 2));
+      m = _mm_min_epu8(m, _mm_srli_si128(m, 1));
+      return _mm_cvtsi128_si32(m) & 0xFF;
+   }
+
+private:
+   /**
+    * split
+    * Make the byte tables of 9 masks: their low bytes and their high
+    * bytes, in entries 0 - 8 of both 128-bit halves.
+    * @param masks 9 digit masks
+    * @param lo set to the low bytes
+    * @param hi set to the high bytes
+    */
+   static void split(const uint16_t* masks, __m256i& lo, __m256i& hi)
+   {
+      __m128i first = _mm_loadu_si128((const __m128i*) masks);
+      __m128i last = _mm_cvtsi32_si128(masks[8]);
+      __m128i low = _mm_set1_epi16(0xFF);
+      lo = _mm256_broadcastsi128_si256(_mm_packus_epi16(
+              _mm_and_si128(first, low), _mm_and_si128(last, low)));
+      hi = _mm256_broadcastsi128_si256(_mm_packus_epi16(
+              _mm_srli_epi16(first, 8), _mm_srli_epi16(last, 8)));
+   }
+
+   /**
+    * load
+    * @param p 32 bytes
+    * @return the bytes, as a vector
+    */
+   static __m256i load(const unsigned char* p) {
+                  return _mm256_loadu_si256((const __m256i*) p); }
+};
+#endif
+
 /**
  * solve
  * Solve the Puzzle.
  * Recursive method: solve Puzzle beginning at pos.
+ * With MRV, branch on the most constrained empty square instead, and
+ * try only its legal digits; pos is not used.
+ * With propagation, fill the singles first, and erase them again if the
+ * Puzzle can't be solved from here.
  * @param pos The index postion of the Puzzle board to start.
  * @return true: Puzzle was solved; false: could not be solved
  */
-bool Puzzle::solve(int pos)
+template <int BOX>
+bool BasicPuzzle<BOX>::solve(int pos)
 {
+   // time the top-level call only
+   SUDOKU_STAT(StatTimer timer(level == 0 ? &seconds : nullptr));
+   SUDOKU_STAT(maxDepth = max(maxDepth, level));
+   // a digit repeated in the input can't be solved
+   if (conflict) return false;
+   // another thread solved the Puzzle first
+   if (cancel != nullptr && cancel->load(memory_order_relaxed)) return false;
+
+   int mark = trailSize;
+   if (propagation && !propagate())
+   {
+      undo(mark);
+      return false;
+   }
+
    // finished when no more empty squares
-   if (getNumEmpty() == 0) return true;
+   if (getNumEmpty() == 0)
+   {
+      assert(blocksAreValid());
+      return true;
+   }
+
+   if (mrv)
+   {
+      int count = 0;
+      int position = getMostConstrainedPos(count);
+      // dead end if an empty square has no legal digit
+      Mask candidates = getCandidates(position);
+      while (candidates != 0)
+      {
+         int value = __builtin_ctz(candidates);
+         candidates &= candidates - 1; // clear the lowest bit
+         set(position, value);
+         nodes++;
+         if (count > 1) guesses++;
+         SUDOKU_STAT(level++);
+         bool solved = solve(0);
+         SUDOKU_STAT(level--);
+         if (solved) return true;
+         erase(position);
+         SUDOKU_STAT(backtracks++);
+      }
+      undo(mark);
+      return false;
+   }
 
    int position = getNextEmptySquarePos(pos);
-   for (int value = 1; value <= 9; value++)
+   Mask candidates = getCandidates(position);
+   bool guess = (candidates & (candidates - 1)) != 0; // 2 or more digits
+   for (int value = 1; value <= PUZZLE_DIM; value++)
    {
       if ( set(position, value) )
       {
-         if (solve(position + 1)) return true;
-         
+         nodes++;
+         if (guess) guesses++;
+         SUDOKU_STAT(level++);
+         bool solved = solve(position + 1);
+         SUDOKU_STAT(level--);
+         if (solved) return true;
+
          erase(position);
+         SUDOKU_STAT(backtracks++);
       }
    } // end for
+   undo(mark);
    return false;
 }
 
+/**
+ * solveParallel
+ * Solve the Puzzle on several threads. The top levels of the search
+ * tree are expanded, breadth first, until there are SPLIT_FACTOR
+ * subtrees for each thread (or the tree is SPLIT_DEPTH levels deep);
+ * each subtree is a copy of the Puzzle, searched by solve() on a
+ * WorkStealingPool. The first subtree solved stops the others.
+ * The subtrees are in the order solve() would search them, and each
+ * thread starts with a contiguous run of them.
+ * The counters add up the work done while expanding and in every
+ * subtree searched; the time is the wall time of the call.
+ * @param nThreads number of threads
+ * @return true: Puzzle was solved; false: could not be solved
+ */
+template <int BOX>
+bool BasicPuzzle<BOX>::solveParallel(int nThreads)
+{
+   WorkStealingPool pool(max(nThreads, 1));
+   return solveParallel(pool);
+}
+
+/**
+ * solveParallel
+ * Solve the Puzzle on the threads of a pool, as above, so a caller that
+ * solves many puzzles starts the threads once.
+ * @param pool threads to search on; not used by another call at once
+ * @return true: Puzzle was solved; false: could not be solved
+ */
+template <int BOX>
+bool BasicPuzzle<BOX>::solveParallel(WorkStealingPool& pool)
+{
+   SUDOKU_STAT(StatTimer timer(&seconds));
+   if (conflict) return false;
+
+   // expand the top levels of the tree
+   vector<BasicPuzzle> frontier(1, *this);
+   frontier[0].setStats(SolveStats());
+   size_t target = (size_t) pool.size() * SPLIT_FACTOR;
+   int expanded = 0; // levels expanded
+   for (; expanded < SPLIT_DEPTH && frontier.size() < target; expanded++)
+   {
+      SUDOKU_STAT(maxDepth = max(maxDepth, expanded));
+      vector<BasicPuzzle> next;
+      for (size_t i = 0; i < frontier.size(); i++)
+      {
+         BasicPuzzle& q = frontier[i];
+         bool dead = q.propagation && !q.propagate();
+         forced += q.forced;
+         q.forced = 0;
+         SUDOKU_STAT(passes += q.passes; q.passes = 0);
+         if (dead)
+            continue;
+         if (q.getNumEmpty() == 0)
+         {
+            // solved while expanding
+            SolveStats total = getStats();
+            *this = q;
+            setStats(total);
+            return true;
+         }
+
+         Mask candidates;
+         int position = q.branch(0, candidates);
+         bool guess = (candidates & (candidates - 1)) != 0;
+         while (candidates != 0)
+         {
+            int value = __builtin_ctz(candidates);
+            candidates &= candidates - 1;
+            next.push_back(q);
+            next.back().set(position, value);
+            nodes++;
+            if (guess) guesses++;
+         }
+      }
+      frontier.swap(next);
+      if (frontier.empty())
+         return false;
+   }
+
+   // search the subtrees until one is solved
+   atomic<bool> solved(false);
+   mutex lock;
+   int winner = -1; // first subtree solved, guarded by lock
+   pool.run(frontier.size(), [&](size_t i, int) {
+      BasicPuzzle& q = frontier[i];
+      q.cancel = &solved;
+      if (q.solve(0))
+      {
+         lock_guard<mutex> guard(lock);
+         if (winner < 0)
+            winner = (int) i;
+         solved = true;
+      }
+   });
+
+   // the subtrees' own times overlap, and are left out
+   SolveStats total = getStats();
+   for (size_t i = 0; i < frontier.size(); i++)
+   {
+      SolveStats sub = frontier[i].getStats();
+      total.nodes += sub.nodes;
+      total.guesses += sub.guesses;
+      total.forced += sub.forced;
+      total.backtracks += sub.backtracks;
+      total.maxDepth = max(total.maxDepth, expanded + sub.maxDepth);
+      total.passes += sub.passes;
+   }
+   if (winner >= 0)
+      *this = frontier[winner];
+   setStats(total);
+   cancel = nullptr;
+   return winner >= 0;
+}
+
+/**
+ * search
+ * Solve the Puzzle without recursion: the squares branched on, the
+ * digits left to try in each and the trail mark of each are kept on
+ * an explicit stack, so backtracking is a pop. Same branching,
+ * propagation and counters as solve().
+ * Each pass of the loop works on the top Frame: erase the digit tried
+ * last, then pop the Frame if no digit is left, or place the next digit
+ * and enter the node below it.
+ * @param budget most nodes to place in this call; 0 for no limit
+ * @return SOLVED, UNSOLVABLE or PAUSED (budget spent)
+ */
+template <int BOX>
+typename BasicPuzzle<BOX>::Status BasicPuzzle<BOX>::search(long budget)
+{
+   SUDOKU_STAT(StatTimer timer(&seconds));
+   if (conflict) return UNSOLVABLE;
+
+   if (depth < 0)
+   {
+      // first call: the root node
+      depth = 0;
+      Status status = enter(0);
+      if (status != PAUSED) return status;
+   }
+
+   long start = nodes;
+   while (depth > 0)
+   {
+      Frame& top = stack[depth - 1];
+      if (top.pos < PUZZLE_SIZE && board[top.pos] != 0)
+      {
+         erase(top.pos);
+         SUDOKU_STAT(backtracks++);
+      }
+
+      Mask left = top.candidates & ALL_DIGITS;
+      if (left == 0)
+      {
+         // every digit tried: backtrack
+         undo(top.mark);
+         depth--;
+         continue;
+      }
+      if (budget > 0 && nodes - start >= budget)
+         return PAUSED;
+
+      int value = __builtin_ctz(left);
+      top.candidates &= ~(1 << value);
+      set(top.pos, value);
+      nodes++;
+      if (top.candidates & GUESS_BIT) guesses++;
+      if (enter(top.pos + 1) == SOLVED)
+         return SOLVED;
+   }
+   return UNSOLVABLE;
+}
+
+/**
+ * countSolutions
+ * Count the solutions of the Puzzle, up to a limit, by resuming
+ * search() after each one, so it prunes the same way as the solver.
+ * The search runs on a copy; the Puzzle is set to the copy at the first
+ * solution.
+ * @param limit most solutions to count, at least 1
+ * @return number of solutions found, 0 - limit
+ * @post the Puzzle holds the first solution, if there is one
+ */
+template <int BOX>
+int BasicPuzzle<BOX>::countSolutions(int limit)
+{
+   BasicPuzzle q = *this;
+   int count = 0;
+   while (count < limit && q.search(0) == SOLVED)
+   {
+      if (++count == 1)
+         *this = q;
+   }
+   setStats(q.getStats());
+   return count;
+}
+
+/**
+ * enter
+ * Start a node of search(): propagate, then push a Frame for the
+ * square to branch on (or a solution Frame, if none is empty).
+ * @param pos first square to look at in scan order
+ * @return SOLVED; PAUSED if a Frame was pushed; UNSOLVABLE if
+ *   propagation found a dead end (its squares are erased again)
+ */
+template <int BOX>
+typename BasicPuzzle<BOX>::Status BasicPuzzle<BOX>::enter(int pos)
+{
+   // one Frame for each digit placed above this node
+   SUDOKU_STAT(maxDepth = max(maxDepth, depth));
+   int mark = trailSize;
+   if (propagation && !propagate())
+   {
+      undo(mark);
+      return UNSOLVABLE;
+   }
+
+   Frame& frame = stack[depth++];
+   frame.mark = mark;
+   if (getNumEmpty() == 0)
+   {
+      // popped when the search is resumed, to undo the propagation
+      assert(blocksAreValid());
+      frame.pos = PUZZLE_SIZE;
+      frame.candidates = 0;
+      return SOLVED;
+   }
+
+   Mask candidates;
+   frame.pos = branch(pos, candidates);
+   frame.candidates = candidates;
+   if ((candidates & (candidates - 1)) != 0)
+      frame.candidates |= GUESS_BIT;
+   return PAUSED;
+}
+
+/**
+ * branch
+ * Get the square solve() would branch on next, and its legal digits:
+ * the most constrained square with MRV, or the first empty square at
+ * or after pos.
+ * @param pos first square to look at in scan order
+ * @param candidates set to the legal digits of the square
+ * @return Location of the Square, or PUZZLE_SIZE if none empty.
+ */
+template <int BOX>
+int BasicPuzzle<BOX>::branch(int pos, Mask& candidates) const
+{
+   int count = 0;
+   int position = mrv ? getMostConstrainedPos(count) :
+                        getNextEmptySquarePos(pos);
+   candidates = (position < PUZZLE_SIZE) ? getCandidates(position) : 0;
+   return position;
+}
+
+/**
+ * propagate
+ * Fill naked and hidden singles (naked only, without hiddenSingles)
+ * until none are left. Each square filled is pushed on the trail.
+ * A unit is checked for hidden singles with two masks: once has the
+ * digits legal in at least one of its empty squares, twice those legal in
+ * at least two.
+ * @return false if a square has no legal digit, or a digit has no legal
+ *   square in a unit (the Puzzle can't be solved); otherwise true
+ */
+template <int BOX>
+bool BasicPuzzle<BOX>::propagate()
+{
+   bool changed = true;
+   while (changed)
+   {
+      changed = false;
+      SUDOKU_STAT(passes++);
+
+      // naked singles
+      if (simd)
+      {
+         // the squares that had 0 or 1 digits when the pass began; an
+         // earlier single may have taken the last digit of one since
+         unsigned char counts[PUZZLE_SIZE];
+         uint64_t fewBits[FEW_WORDS];
+         getCandidateCounts(counts, fewBits, true);
+         for (int w = 0; w < FEW_WORDS; w++)
+         {
+            for (uint64_t bits = fewBits[w]; bits != 0; bits &= bits - 1)
+            {
+               int pos = w * 64 + __builtin_ctzll(bits);
+               Mask candidates = getCandidates(pos);
+               if (candidates == 0)
+                  return false;
+               force(pos, __builtin_ctz(candidates));
+               changed = true;
+            }
+         }
+      }
+      for (int pos = 0; pos < PUZZLE_SIZE && !simd; pos++)
+      {
+         if (board[pos] != 0)
+            continue;
+         Mask candidates = getCandidates(pos);
+         if (candidates == 0)
+            return false;
+         if ((candidates & (candidates - 1)) == 0)
+         {
+            force(pos, __builtin_ctz(candidates));
+            changed = true;
+         }
+      }
+
+      // hidden singles
+      for (int unit = 0; unit < 3 * PUZZLE_DIM && hiddenSingles; unit++)
+      {
+         Mask once = 0;
+         Mask twice = 0;
+         for (int k = 0; k < PUZZLE_DIM; k++)
+         {
+            int pos = unitPos(unit, k);
+            if (board[pos] != 0)
+               continue;
+            Mask candidates = getCandidates(pos);
+            twice |= once & candidates;
+            once |= candidates;
+         }
+         // every digit is either used or legal somewhere in the unit
+         if ((once | unitMask(unit)) != ALL_DIGITS)
+            return false;
+
+         Mask hidden = once & ~twice;
+         for (int k = 0; k < PUZZLE_DIM && hidden != 0; k++)
+         {
+            int pos = unitPos(unit, k);
+            if (board[pos] != 0)
+               continue;
+            Mask single = getCandidates(pos) & hidden;
+            if (single == 0)
+               continue;
+            // two digits that each have only this square
+            if ((single & (single - 1)) != 0)
+               return false;
+            force(pos, __builtin_ctz(single));
+            hidden &= ~single;
+            changed = true;
+         }
+      }
+   }
+   return true;
+}
+
+/**
+ * force
+ * Fill a single found by propagate(), and push it on the trail.
+ * @param pos Location of the empty Square
+ * @param value its only legal digit
+ */
+template <int BOX>
+void BasicPuzzle<BOX>::force(int pos, int value)
+{
+   bool valid = set(pos, value);
+   assert(valid);
+   (void) valid;
+   trail[trailSize++] = pos;
+   forced++;
+}
+
+/**
+ * undo
+ * Erase the squares filled by propagate() since the trail had mark
+ * entries.
+ * @param mark trail size to go back to
+ */
+template <int BOX>
+void BasicPuzzle<BOX>::undo(int mark)
+{
+   while (trailSize > mark)
+      erase(trail[--trailSize]);
+}
+
+/**
+ * unitPos
+ * Get a Square of a unit: one of the 9 rows (units 0 - 8), 9 columns
+ * (units 9 - 17) or 9 Blocks (units 18 - 26); PUZZLE_DIM of each on
+ * a larger board.
+ * @param unit unit index, 0 - 26
+ * @param k index of the Square in the unit, 0 - 8
+ * @return Location of the Square in the Puzzle board
+ */
+template <int BOX>
+int BasicPuzzle<BOX>::unitPos(int unit, int k)
+{
+   if (unit < PUZZLE_DIM)
+      return unit * PUZZLE_DIM + k;
+   if (unit < 2 * PUZZLE_DIM)
+      return k * PUZZLE_DIM + (unit - PUZZLE_DIM);
+   int block = unit - 2 * PUZZLE_DIM;
+   int row = block / BLOCK_DIM * BLOCK_DIM + k / BLOCK_DIM;
+   int col = block % BLOCK_DIM * BLOCK_DIM + k % BLOCK_DIM;
+   return row * PUZZLE_DIM + col;
+}
+
+/**
+ * unitMask
+ * Get the digits used in a unit (see unitPos).
+ * @param unit unit index, 0 - 26
+ * @return bitmask with bit v set if digit v is in the unit
+ */
+template <int BOX>
+typename BasicPuzzle<BOX>::Mask BasicPuzzle<BOX>::unitMask(int unit) const
+{
+   if (unit < PUZZLE_DIM)
+      return rowMask[unit];
+   if (unit < 2 * PUZZLE_DIM)
+      return colMask[unit - PUZZLE_DIM];
+   return blockMask[unit - 2 * PUZZLE_DIM];
+}
+
+/**
+ * getMostConstrainedPos
+ * Get the empty Square with the fewest legal digits (the first one,
+ * if there is a tie). Stops early at a Square with 0 or 1; with simd,
+ * counts every Square with getCandidateCounts, then looks for the least.
+ * @param count set to the number of legal digits of that Square
+ * @return The position of the Square, or PUZZLE_SIZE if none empty.
+ */
+template <int BOX>
+int BasicPuzzle<BOX>::getMostConstrainedPos(int& count) const
+{
+   if (simd)
+   {
+      unsigned char counts[PUZZLE_SIZE];
+      uint64_t fewBits[FEW_WORDS];
+      int least = getCandidateCounts(counts, fewBits, true);
+      for (int w = 0; w < FEW_WORDS; w++)
+      {
+         if (fewBits[w] != 0)
+         {
+            int pos = w * 64 + __builtin_ctzll(fewBits[w]);
+            count = counts[pos];
+            return pos;
+         }
+      }
+      if (least == FILLED)
+      {
+         count = PUZZLE_DIM + 1;
+         return PUZZLE_SIZE;
+      }
+      count = least;
+      return (int) ((const unsigned char*) memchr(counts, least, PUZZLE_SIZE)
+                    - counts);
+   }
+
+   int best = PUZZLE_SIZE;
+   count = PUZZLE_DIM + 1;
+   for (int pos = 0; pos < PUZZLE_SIZE && count > 1; pos++)
+   {
+      if (board[pos] != 0)
+         continue;
+      int legal = __builtin_popcount(getCandidates(pos));
+      if (legal < count)
+      {
+         count = legal;
+         best = pos;
+      }
+   }
+   return best;
+}
+
+/**
+ * getStats
+ * Get what solve(), search(), solveParallel() and countSolutions() have
+ * done on this Puzzle, added up over all the calls.
+ * @return the counters; without SUDOKU_STATS, only nodes, guesses and
+ *   forced
+ */
+template <int BOX>
+SolveStats BasicPuzzle<BOX>::getStats() const
+{
+   SolveStats stats;
+   stats.nodes = nodes;
+   stats.guesses = guesses;
+   stats.forced = forced;
+#ifdef SUDOKU_STATS
+   stats.backtracks = backtracks;
+   stats.maxDepth = maxDepth;
+   stats.passes = passes;
+   stats.seconds = seconds;
+#endif
+   return stats;
+}
+
+/**
+ * setStats
+ * Set the counters, as getStats() returns them.
+ * @param stats the counters; those not kept without SUDOKU_STATS are
+ *   ignored
+ */
+template <int BOX>
+void BasicPuzzle<BOX>::setStats(const SolveStats& stats)
+{
+   nodes = stats.nodes;
+   guesses = stats.guesses;
+   forced = stats.forced;
+#ifdef SUDOKU_STATS
+   backtracks = stats.backtracks;
+   maxDepth = stats.maxDepth;
+   passes = stats.passes;
+   seconds = stats.seconds;
+#endif
+}
+
+/**
+ * hasSimd
+ * @return true if getCandidateCounts has a vector kernel for this
+ *   board size (9x9, built with AVX2)
+ */
+template <int BOX>
+bool BasicPuzzle<BOX>::hasSimd()
+{
+   return CandidateKernel<BOX>::AVAILABLE;
+}
+
+/**
+ * getCandidateCounts
+ * Count the legal digits of every empty square.
+ * @param counts set to the count of each empty square, and to FILLED
+ *   for the others; PUZZLE_SIZE entries
+ * @param fewBits bit pos % 64 of word pos / 64 set if the square at
+ *   pos is empty with 0 or 1 legal digits, the others cleared;
+ *   FEW_WORDS words
+ * @param simd true: with the vector kernel, if hasSimd(); false: with
+ *   a scalar loop
+ * @return the least count of an empty square, or FILLED if none empty
+ */
+template <int BOX>
+int BasicPuzzle<BOX>::getCandidateCounts(unsigned char* counts,
+                                         uint64_t* fewBits, bool simd) const
+{
+   if (simd && CandidateKernel<BOX>::AVAILABLE)
+      return CandidateKernel<BOX>::run(board, rowMask, colMask, blockMask,
+                                       counts, fewBits);
+
+   int least = FILLED;
+   for (int w = 0; w < FEW_WORDS; w++)
+      fewBits[w] = 0;
+   for (int pos = 0; pos < PUZZLE_SIZE; pos++)
+   {
+      if (board[pos] != 0)
+      {
+         counts[pos] = FILLED;
+         continue;
+      }
+      int legal = __builtin_popcount(getCandidates(pos));
+      counts[pos] = (unsigned char) legal;
+      if (legal <= 1)
+         fewBits[pos / 64] |= (uint64_t) 1 << (pos % 64);
+      if (legal < least)
+         least = legal;
+   }
+   return least;
+}
+
 /**
  * set
  * Set the Square at location pos to value if valid.
- * Check that the new value is valid for the column
- * and row of the position, and all the blocks.
- * The method sets the value of the square, then checks for validity.
- * If not valid, then the square is reset to 0.
+ * Check that the new value is valid for the row, column
+ * and block of the position, then set the value of the square.
  * Calls:
  *   isValidRow(pos, value)
  *   isValidCol(pos, value)
- *   blocksAreValid()
- *   erase(pos)
+ *   isValidBlock(pos, value)
  * @param pos Location of the Square in board[]
  * @param value Proposed value to add to Square
  * @return true: new value is valid, and was added; false: new value is
  * not valid and was not added.
  */
-bool Puzzle::set(int pos, int value)
+template <int BOX>
+bool BasicPuzzle<BOX>::set(int pos, int value)
 {
-   assert(value >= 1 && value <= 9);
-   assert(board[pos].getIsFixed() == false);
-   // set the Square at pos to value, then check if valid
-   board[pos].setValue(value);
-   decrementNumEmpty();
-   if (isValidRow(pos, value) && isValidCol(pos, value) &&
-                                                blocksAreValid())
+   assert(value >= 1 && value <= PUZZLE_DIM);
+   assert(!isFixed(pos));
+   if (!isValidRow(pos, value) || !isValidCol(pos, value) ||
+                                             !isValidBlock(pos, value))
    {
-      return true;
+      return false;
    }
-   // not valid, so erase
-   erase(pos); // increments numEmpty
+   place(pos, value);
+   decrementNumEmpty();
 
-   return false;
+   return true;
+}
+
+/**
+ * place
+ * Put value in the Square at pos, and add it to the bitmasks of the
+ * row, column and Block. Record a conflict if a bitmask already has
+ * the value.
+ * @param pos The index position of the Square in the Puzzle board.
+ * @param value The value to insert, 1 - PUZZLE_DIM.
+ */
+template <int BOX>
+void BasicPuzzle<BOX>::place(int pos, int value)
+{
+   Mask bit = (Mask) (1u << value);
+   Mask& row = rowMask[rowOf(pos)];
+   Mask& col = colMask[colOf(pos)];
+   Mask& block = blockMask[blockOf(pos)];
+
+   if ((row | col | block) & bit)
+      conflict = true;
+   row |= bit;
+   col |= bit;
+   block |= bit;
+   board[pos] = value;
+}
+
+/**
+ * erase
+ * Erase (set to 0) the Square at position pos, and remove its value
+ * from the bitmasks.
+ * Increment numEmpty.
+ * @param pos The index position of the Square in the Puzzle board.
+ * @pre The value at pos is a digit 1 - PUZZLE_DIM.
+ * @post The value at pos is set to 0.
+ */
+template <int BOX>
+void BasicPuzzle<BOX>::erase(int pos)
+{
+   Mask bit = (Mask) ~(1u << board[pos]);
+   rowMask[rowOf(pos)] &= bit;
+   colMask[colOf(pos)] &= bit;
+   blockMask[blockOf(pos)] &= bit;
+   board[pos] = 0;
+   this->numEmpty++;
 }
 
 /**
@@ -85,99 +925,36 @@ bool Puzzle::set(int pos, int value)
  * @return The position of the next empty Square, or PUZZLE_SIZE if
  * none remaining.
  */
-int Puzzle::getNextEmptySquarePos(int pos)
+template <int BOX>
+int BasicPuzzle<BOX>::getNextEmptySquarePos(int pos) const
 {
    int value = 0;
    // get the next empty Square, unless past end of board
-   while (pos < PUZZLE_SIZE && (value = board[pos].getValue()) != 0)
+   while (pos < PUZZLE_SIZE && (value = board[pos]) != 0)
    {
       pos++;
    }
    return pos;
 }
 
-/**
- * isValidRow
- * Determine if the new value would be valid for the row associated
- * with this position in the Puzzle board.
- * row = pos / 9 (ie, PUZZLE_DIM)
- * @param pos Location of the current Square in the Puzzle board to test
- * @param value The proposed new value to add to the current Square
- * @return true: adding this value would result in a valid Row;
- *   false: would not be valid.
- */
-bool Puzzle::isValidRow(int pos, int value)
-{
-   // get the row associated with this position
-   int row = pos / PUZZLE_DIM;
-   // search for duplicate values > 1
-   int numDups = 0;
-   // pointer to the first Square of the row
-   Square *curPos = &board[row * PUZZLE_DIM];
-   for (int i = 0; i < PUZZLE_DIM && numDups < 2; i++)
-   {
-      int curValue = curPos->getValue();
-      if (curValue == value && curValue != 0)
-      {
-         numDups++;
-      }
-      curPos++;
-   }
-
-   // if the numDups < 2, the row is valid and return true
-   // else return false
-   return (numDups < 2) ? true : false;
-}
-
-/**
- * isValidCol
- * Determine if the new value would be valid for the column associated
- * with this position in the Puzzle board.
- * column = pos % 9 (ie, PUZZLE_DIM)
- * @param pos Location of the current Square in the Puzzle board to test
- * @param value The proposed new value to add to the current Square
- * @return true: adding this value would result in a valid column;
- *   false: would not be valid.
- */
-bool Puzzle::isValidCol(int pos, int value)
-{
-   // get the column associated with this position
-   int col = pos % PUZZLE_DIM;
-   // search for duplicate value
-   int numDups = 0; // number of duplicates found
-   // pointer to the first Square of the column
-   Square* curPos = &board[col];
-   for (int i = 0; i < PUZZLE_DIM && numDups < 2; i++)
-   {
-      int curValue = curPos->getValue();
-      // count the number of duplicate values, ignoring 0
-      if (curValue == value && curValue != 0)
-      {
-         numDups++;
-      }
-      curPos += PUZZLE_DIM; // next row
-   }
-   
-   // if the numDups < 2, the column is valid and return true
-   // else return false
-   return (numDups < 2) ? true : false;
-}
-
 /**
  * blocksAreValid
  * Check of all the Blocks associated with the Puzzle board are valide.
- * Proposed new value has already been set.
+ * Rescans every Square; used only to check the bitmasks.
  * @return true: all blocks are valid; false: at least one is not valid.
  */
-bool Puzzle::blocksAreValid()
+template <int BOX>
+bool BasicPuzzle<BOX>::blocksAreValid() const
 {
    bool valid = true;
 
-   // check each Block in blocks
+   // check each Block of the board
    for (int i = 0; i < PUZZLE_DIM && valid; i++)
    {
+      // upper left corner of the Block
+      int corner = unitPos(2 * PUZZLE_DIM + i, 0);
       // set valid to false if any block is invalid
-      if (!blocks[i].isValid())
+      if (!BasicBlock<BOX>(corner).isValid(board))
       {
          valid = false;
       }
@@ -194,34 +971,40 @@ bool Puzzle::blocksAreValid()
  * @param p Reference to Puzzle instance.
  * @output Reference to ostream after operation.
  */
-ostream& operator<<(ostream& os, Puzzle& p)
+template <int BOX>
+ostream& operator<<(ostream& os, BasicPuzzle<BOX>& p)
 {
-   Square& firstSquare = p.getPuzzleBoard();
-   Square* initPos = &firstSquare;
-   Square* curPos = initPos;
-   const string BORDER_BAR = "+-------+-------+-------+";
-   const string MID_BAR = "|-------+-------+-------|";
+   const int PUZZLE_DIM = BasicPuzzle<BOX>::PUZZLE_DIM;
+   const unsigned char* initPos = p.board;
+   const unsigned char* curPos = initPos;
+   // "+-------+-------+-------+" and "|-------+-------+-------|" for 9x9
+   const string DASHES(2 * BOX + 1, '-');
+   string BORDER_BAR = "+";
+   for (int b = 0; b < BOX; b++)
+      BORDER_BAR += DASHES + "+";
+   string MID_BAR = BORDER_BAR;
+   MID_BAR[0] = MID_BAR[MID_BAR.length() - 1] = '|';
 
    // top row
    cout << BORDER_BAR << endl;
-   for (int i = 0; i < Puzzle::PUZZLE_DIM; i++)
+   for (int i = 0; i < PUZZLE_DIM; i++)
    {
       cout << "| ";
-      for (int j = 0; j < Puzzle::PUZZLE_DIM; j++)
+      for (int j = 0; j < PUZZLE_DIM; j++)
       {
-         int value = curPos->getValue();
+         int value = *curPos;
          if (value == 0)
             cout << "  ";
          else
-            cout << value << " ";
-         if ( (j + 1) % 3 == 0) cout << "| ";
+            cout << BasicPuzzle<BOX>::symbol(value) << " ";
+         if ( (j + 1) % BOX == 0) cout << "| ";
          curPos++;
       }
       cout << endl;
-      if ( (i + 1) % 3 == 0 && i < Puzzle::PUZZLE_DIM - 1)
+      if ( (i + 1) % BOX == 0 && i < PUZZLE_DIM - 1)
          cout << MID_BAR << endl;
       // next row
-      initPos += Puzzle::PUZZLE_DIM;
+      initPos += PUZZLE_DIM;
       curPos = initPos;
    }
    cout << BORDER_BAR << endl << endl;
@@ -229,29 +1012,143 @@ ostream& operator<<(ostream& os, Puzzle& p)
    return os;
 }
 
+/**
+ * valueOf
+ * Get the digit a character stands for (see symbol); lower case
+ * letters are read as upper case.
+ * @param ch character
+ * @return its digit, 0 - PUZZLE_DIM, or -1 if it is not one
+ */
+template <int BOX>
+int BasicPuzzle<BOX>::valueOf(char ch)
+{
+   int value = -1;
+   if (ch >= '0' && ch <= '9')
+      value = ch - '0';
+   else if (ch >= 'A' && ch <= 'Z')
+      value = ch - 'A' + 10;
+   else if (ch >= 'a' && ch <= 'z')
+      value = ch - 'a' + 10;
+   return value <= PUZZLE_DIM ? value : -1;
+}
+
+/**
+ * read
+ * Load the Puzzle from one line of text: PUZZLE_SIZE characters
+ * (81 for 9x9), the digits (see symbol) of the given squares and
+ * 0 or '.' for empty squares.
+ * Used by batch solving, instead of operator>>.
+ * @param line puzzle line, without the newline
+ * @return true: the line was loaded; false: the line is not a puzzle,
+ *   and the Puzzle was not changed
+ * @pre The Puzzle is empty (default constructed).
+ */
+template <int BOX>
+bool BasicPuzzle<BOX>::read(const string& line)
+{
+   if (line.length() != PUZZLE_SIZE)
+      return false;
+
+   string digits = line;
+   for (int i = 0; i < PUZZLE_SIZE; i++)
+   {
+      if (digits[i] == '.')
+         digits[i] = '0';
+      else if (valueOf(digits[i]) < 0)
+         return false;
+   }
+   load(digits);
+   return true;
+}
+
+/**
+ * load
+ * Put the digits of a puzzle into the Puzzle board, and set the
+ * fixed, empty and variable Squares.
+ * @param digits PUZZLE_SIZE digits (see symbol), 0 for an empty Square
+ * @pre The Puzzle is empty (default constructed).
+ */
+template <int BOX>
+void BasicPuzzle<BOX>::load(const string& digits)
+{
+   setValidInput(true);
+   for (int i = 0; i < PUZZLE_SIZE; i++)
+   {
+      // put the digit into the Square
+      // valueOf converts the character to an int
+      char digit = digits.at(i);
+      setValue(i, valueOf(digit));
+
+      if (digit == '0')
+      {
+         // an empty square
+         incrementNumEmpty();
+         incrmentNumVariable();
+      }
+      else
+      {
+         // square with initial value
+         fixedBits[i / 64] |= (uint64_t) 1 << (i % 64);
+      }
+   } // end for
+}
+
+/**
+ * get
+ * Get the Square at location pos in the Puzzle board: its value, and
+ * whether it is fixed.
+ * @param pos Position of the square on the Puzzle board
+ * @return a Square object (a copy; use set to change the board)
+ */
+template <int BOX>
+Square BasicPuzzle<BOX>::get(int pos) const
+{
+   Square square;
+   square.setValue(board[pos]);
+   square.setIsFixed(isFixed(pos));
+   return square;
+}
+
+/**
+ * write
+ * Print the Puzzle as one line of PUZZLE_SIZE digits (see symbol),
+ * 0 for an empty Square, without a newline.
+ * @param os Reference to ostream.
+ */
+template <int BOX>
+void BasicPuzzle<BOX>::write(ostream& os) const
+{
+   char line[PUZZLE_SIZE];
+   for (int i = 0; i < PUZZLE_SIZE; i++)
+      line[i] = symbol(board[i]);
+   os.write(line, PUZZLE_SIZE);
+}
+
 /**
  * operator >>
  * Overloaded input stream operator.
  * Accepts character input.
- * Reads first 81 digits, then attempts to solve puzzle.
- * Ignore any chars that are not digits.
+ * Reads first 81 (PUZZLE_SIZE) digits, then attempts to solve puzzle.
+ * Ignore any chars that are not digits (see symbol).
  * If < 81 digits, do not alter puzzle, print error message.
  * If > 81 digits, only read the first 81.
  * @param is Reference to the input stream (istream&).
  * @param p Reference to the Puzzle instance.
  * @return Reference to istream after reading characters.
  */
-istream& operator>>(istream& is, Puzzle& p)
+template <int BOX>
+istream& operator>>(istream& is, BasicPuzzle<BOX>& p)
 {
+   const size_t PUZZLE_SIZE = BasicPuzzle<BOX>::PUZZLE_SIZE;
    string str = "";
    bool success = true;
    char ch = '\0';
-   int count = 0;
+   size_t count = 0;
 
    // read until Puzzle:PUZZLE_SIZE chars read or EOF
-   while (is.get(ch) && count < Puzzle::PUZZLE_SIZE)
+   while (is.get(ch) && count < PUZZLE_SIZE)
    {
-      if (ch >= '0' && ch <= '9')
+      if (BasicPuzzle<BOX>::valueOf(ch) >= 0)
       {
          str += ch;
          count++;
@@ -259,36 +1156,14 @@ istream& operator>>(istream& is, Puzzle& p)
    }
 
    // if string length < PUZZLE_SIZE (81), an invalid input
-   if (str.length() < Puzzle::PUZZLE_SIZE) success = false;
+   if (str.length() < PUZZLE_SIZE) success = false;
 
    // load digits into Puzzle if success
    if (success)
    {
       // correct input data
-      assert(str.length() == Puzzle::PUZZLE_SIZE);
-      p.setValidInput(true);
-      for (int i = 0; i < Puzzle::PUZZLE_SIZE; i++)
-      {
-         // put the digit into the Square
-         // subtract '0' to convert to an int
-         Square& square = p.get(i);
-         char digit = str.at(i);
-         p.setValue(i, digit - '0');
-         
-         if (digit == '0')
-         {
-            // an empty square
-            square.setIsFixed(false);
-            p.incrementNumEmpty();
-            p.incrmentNumVariable();
-         }
-         else
-         {
-            // square with initial value
-            square.setIsFixed(true);
-         }
-            
-      } // end for
+      assert(str.length() == PUZZLE_SIZE);
+      p.load(str);
    } // end if
    else
    {
@@ -299,3 +1174,17 @@ istream& operator>>(istream& is, Puzzle& p)
 
    return is;
 }
+
+// the board sizes: 4x4, 9x9, 16x16 and 25x25
+template class BasicPuzzle<2>;
+template class BasicPuzzle<3>;
+template class BasicPuzzle<4>;
+template class BasicPuzzle<5>;
+template ostream& operator<<(ostream& os, BasicPuzzle<2>& p);
+template ostream& operator<<(ostream& os, BasicPuzzle<3>& p);
+template ostream& operator<<(ostream& os, BasicPuzzle<4>& p);
+template ostream& operator<<(ostream& os, BasicPuzzle<5>& p);
+template istream& operator>>(istream& is, BasicPuzzle<2>& p);
+template istream& operator>>(istream& is, BasicPuzzle<3>& p);
+template istream& operator>>(istream& is, BasicPuzzle<4>& p);
+template istream& operator>>(istream& is, BasicPuzzle<5>& p);
@@ -4,31 +4,120 @@
  * 11/5/17
  * 
  * This class represents a Sudoku puzzle board.
- * The class contains a board array of Square objects, with
- * operations to add a value, erase a value, and check the validity of
- * a proposed digit in an empty square.
- * The puzzle is solved with a recursive backtracking algorithm.
+ * The class contains a packed board, a byte for each square's value and
+ * a bitmap of the fixed squares, with operations to add a value, erase a
+ * value, and check the validity of a proposed digit in an empty square.
+ * A Puzzle holds no pointers into itself, so it is trivially copyable:
+ * a copy is a plain memory copy of a few hundred bytes.
+ * The digits used in each row, column and block are kept as bitmasks,
+ * updated on each set and erase, so checking a proposed digit is O(1).
+ * The puzzle is solved with a recursive backtracking algorithm, which
+ * branches on the next empty square in scan order, or, with the minimum
+ * remaining values (MRV) heuristic, on the empty square with the fewest
+ * legal digits.
+ * With constraint propagation, each node of the search first fills every
+ * naked single (a square with one legal digit) and hidden single (a digit
+ * with one legal square in a row, column or block), until none are left.
+ * The squares it fills are kept on a trail, and erased on backtrack.
+ * search() is an iterative version of solve(), with an explicit stack
+ * of the squares branched on, which can stop after a number of nodes and
+ * be resumed later.
+ * A hard puzzle can also be solved on several threads: the top levels of
+ * the search tree are expanded into copies of the Puzzle, one for each
+ * subtree, which are searched at once until one finds a solution.
+ * The board size is a template parameter: BasicPuzzle<BOX> solves
+ * puzzles of BOX x BOX blocks of BOX x BOX squares (4x4, 9x9, 16x16 or
+ * 25x25), and the bitmask and index types are the smallest that fit.
+ * Puzzle is the usual 9x9 BasicPuzzle<3>.
+ * The legal digits of every square can be counted at once, to pick the
+ * MRV square and find naked singles; built with AVX2 (-mavx2), a 9x9
+ * board does this with a vector kernel.
+ * Built with -DSUDOKU_STATS, a Puzzle also counts its backtracks, depth
+ * and propagation passes, and times each solve (see getStats).
  */
 #pragma once
 
 #include "Square.h"
 #include "Block.h"
+#include "SolveStats.h"
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <type_traits>
 
-class Puzzle
+class WorkStealingPool;
+template <int BOX> class BasicPuzzle;
+template <int BOX>
+std::ostream& operator<<(std::ostream& os, BasicPuzzle<BOX>& p);
+template <int BOX>
+std::istream& operator>>(std::istream& is, BasicPuzzle<BOX>& p);
+
+template <int BOX>
+class BasicPuzzle
 {
-   const static int PUZZLE_SIZE = 81;
-   const static int PUZZLE_DIM = 9;
-   // upper left corner offsets for each block
-   enum {BK_1 = 0,  BK_2 = 3,  BK_3 = 6,
-         BK_4 = 27, BK_5 = 30, BK_6 = 33,
-         BK_7 = 54, BK_8 = 57, BK_9 = 60};
+   static_assert(BOX >= 2 && BOX <= 5,
+                 "digits are written 1 - 9 and A - P, so at most 25x25");
+
+   const static int BLOCK_DIM = BOX;
+   const static int PUZZLE_DIM = BOX * BOX;
+   const static int PUZZLE_SIZE = PUZZLE_DIM * PUZZLE_DIM;
+   const static int SPLIT_FACTOR = 16; // subtrees for each thread
+   const static int SPLIT_DEPTH = 8; // most levels expanded
 
 public:
+   /**
+    * Bitmask of digits, bit v for digit v (bit 0 is not a digit): the
+    * smallest unsigned type with PUZZLE_DIM + 1 bits.
+    */
+   typedef typename std::conditional<PUZZLE_DIM < 8, uint8_t,
+           typename std::conditional<PUZZLE_DIM < 16, uint16_t,
+                                     uint32_t>::type>::type Mask;
+
+   /**
+    * Position of a square, or a count of squares: the smallest unsigned
+    * type that holds PUZZLE_SIZE.
+    */
+   typedef typename std::conditional<PUZZLE_SIZE < 256, uint8_t,
+                                     uint16_t>::type Index;
+
+private:
+   const static Mask ALL_DIGITS = (Mask) ((1u << (PUZZLE_DIM + 1)) - 2);
+
+public:
+   /**
+    * Result of search().
+    */
+   enum Status
+   {
+      SOLVED, // the Puzzle holds a solution
+      UNSOLVABLE, // there is no (further) solution
+      PAUSED // the node budget was spent; call search() again to resume
+   };
+
    /**
     * default constructor
     */
-   Puzzle() {}
+   BasicPuzzle() {}
+
+   /**
+    * symbol
+    * Get the character a digit is written as: '0' for an empty square,
+    * then 1 - 9 and A - P.
+    * @param value digit, 0 - PUZZLE_DIM
+    * @return its character
+    */
+   static char symbol(int value) {
+                  return value < 10 ? '0' + value : 'A' + value - 10; }
+
+   /**
+    * valueOf
+    * Get the digit a character stands for (see symbol); lower case
+    * letters are read as upper case.
+    * @param ch character
+    * @return its digit, 0 - PUZZLE_DIM, or -1 if it is not one
+    */
+   static int valueOf(char ch);
 
    /**
    * size 
@@ -79,32 +168,119 @@ public:
    bool getValidInput() { return this->validInput; }
    
    /**
-    * getPuzzleBoard
-    * Get a reference to the first Square in the Puzzle board
-    * @return Reference to first Square in Puzzle board
+    * get
+    * Get the Square at location pos in the Puzzle board: its value, and
+    * whether it is fixed.
+    * @param pos Position of the square on the Puzzle board
+    * @return a Square object (a copy; use set to change the board)
     */
-   Square& getPuzzleBoard() { return board[0]; }
+   Square get(int pos) const;
 
    /**
-    * get
-    * Get a reference to the Square at location pos in the Puzzle board.
-    * @param pos Position of the square on the Puzzle board
-    * @return Reference to a Square object
+    * getNodes
+    * Get the number of digits placed by solve() (search tree nodes).
+    * @return number of nodes
+    */
+   long getNodes() const { return this->nodes; }
+
+   /**
+    * setMRV
+    * Choose how solve() picks the next square to fill.
+    * @param mrv true: the empty square with the fewest legal digits
+    *   (minimum remaining values); false: the next empty square in
+    *   scan order
+    */
+   void setMRV(bool mrv) { this->mrv = mrv; }
+
+   /**
+    * setPropagate
+    * Choose whether solve() fills naked and hidden singles at each node
+    * before it branches.
+    * @param propagate true: fill singles; false: branch only
     */
-   Square& get(int pos){ return board[pos]; }
+   void setPropagate(bool propagate) { this->propagation = propagate; }
+
+   /**
+    * setHiddenSingles
+    * Choose whether propagation fills hidden singles as well as naked
+    * singles (the default), to tell which a puzzle needs.
+    * @param hidden true: naked and hidden singles; false: naked only
+    */
+   void setHiddenSingles(bool hidden) { this->hiddenSingles = hidden; }
+
+   /**
+    * setSimd
+    * Choose whether MRV and propagation count the legal digits of every
+    * square at once (getCandidateCounts) instead of one square at a
+    * time. The search is the same either way.
+    * @param simd true: count all squares at once, with the AVX2 kernel
+    *   if hasSimd(); false: one square at a time
+    */
+   void setSimd(bool simd) { this->simd = simd; }
+
+   /**
+    * hasSimd
+    * @return true if getCandidateCounts has a vector kernel for this
+    *   board size (9x9, built with AVX2)
+    */
+   static bool hasSimd();
+
+   /**
+    * getCandidateCounts
+    * Count the legal digits of every empty square.
+    * @param counts set to the count of each empty square, and to FILLED
+    *   for the others; PUZZLE_SIZE entries
+    * @param fewBits bit pos % 64 of word pos / 64 set if the square at
+    *   pos is empty with 0 or 1 legal digits, the others cleared;
+    *   FEW_WORDS words
+    * @param simd true: with the vector kernel, if hasSimd(); false: with
+    *   a scalar loop
+    * @return the least count of an empty square, or FILLED if none empty
+    */
+   int getCandidateCounts(unsigned char* counts, uint64_t* fewBits,
+                          bool simd) const;
+
+   // getCandidateCounts value for a square that is not empty
+   const static unsigned char FILLED = 0xFF;
+   // words in the fewBits of getCandidateCounts
+   const static int FEW_WORDS = (PUZZLE_SIZE + 63) / 64;
+
+   /**
+    * getGuesses
+    * Get the number of digits placed by solve() in a square that had more
+    * than one legal digit. A puzzle solved with no guesses was solved by
+    * propagation alone.
+    * @return number of guesses
+    */
+   long getGuesses() const { return this->guesses; }
+
+   /**
+    * getForced
+    * Get the number of singles filled by constraint propagation.
+    * @return number of forced digits
+    */
+   long getForced() const { return this->forced; }
+
+   /**
+    * getStats
+    * Get what solve(), search(), solveParallel() and countSolutions()
+    * have done on this Puzzle, added up over all the calls. The time is
+    * that of the calls made on it (solveParallel: wall time, not the time
+    * of each thread). Without SUDOKU_STATS, only nodes, guesses and
+    * forced are counted.
+    * @return the counters
+    */
+   SolveStats getStats() const;
 
    /**
     * set
     * Set the Square at location pos to value if valid.
-    * Check that the new value is valid for the column
-    * and row of the position, and all the blocks.
-    * The method sets the value of the square, then checks for validity.
-    * If not valid, then the square is reset to 0.
+    * Check that the new value is valid for the row, column
+    * and block of the position, then set the value of the square.
     * Calls:
     *   isValidRow(pos, value)
     *   isValidCol(pos, value)
-    *   blocksAreValid()
-    *   erase(pos)
+    *   isValidBlock(pos, value)
     * @param pos Location of the Square in board[]
     * @param value Proposed value to add to Square
     * @return true: new value is valid, and was added; false: new value is
@@ -112,6 +288,27 @@ public:
     */
    bool set(int pos, int value);
 
+   /**
+    * read
+    * Load the Puzzle from one line of text: PUZZLE_SIZE characters
+    * (81 for 9x9), the digits (see symbol) of the given squares and
+    * 0 or '.' for empty squares.
+    * Used by batch solving, instead of operator>>.
+    * @param line puzzle line, without the newline
+    * @return true: the line was loaded; false: the line is not a puzzle,
+    *   and the Puzzle was not changed
+    * @pre The Puzzle is empty (default constructed).
+    */
+   bool read(const std::string& line);
+
+   /**
+    * write
+    * Print the Puzzle as one line of PUZZLE_SIZE digits (see symbol),
+    * 0 for an empty Square, without a newline.
+    * @param os Reference to ostream.
+    */
+   void write(std::ostream& os) const;
+
    /**
     * solve
     * Solve the Puzzle.
@@ -121,51 +318,279 @@ public:
     */
    bool solve(int pos);
 
+   /**
+    * solveParallel
+    * Solve the Puzzle on several threads. The top levels of the search
+    * tree are expanded, breadth first, until there are SPLIT_FACTOR
+    * subtrees for each thread (or the tree is SPLIT_DEPTH levels deep);
+    * each subtree is a copy of the Puzzle, searched by solve() on a
+    * WorkStealingPool. The first subtree solved stops the others.
+    * Uses the same MRV and propagation settings as solve().
+    * @param nThreads number of threads
+    * @return true: Puzzle was solved; false: could not be solved
+    */
+   bool solveParallel(int nThreads);
+
+   /**
+    * solveParallel
+    * Solve the Puzzle on the threads of a pool, as above, so a caller
+    * that solves many puzzles starts the threads once.
+    * @param pool threads to search on; not used by another call at once
+    * @return true: Puzzle was solved; false: could not be solved
+    */
+   bool solveParallel(WorkStealingPool& pool);
+
+   /**
+    * search
+    * Solve the Puzzle without recursion: the squares branched on, the
+    * digits left to try in each and the trail mark of each are kept on
+    * an explicit stack, so backtracking is a pop. Same branching,
+    * propagation and counters as solve().
+    * The search can be stopped after a number of nodes and resumed by
+    * calling search() again. After SOLVED, calling search() again goes
+    * on to the next solution.
+    * @param budget most nodes to place in this call; 0 for no limit
+    * @return SOLVED, UNSOLVABLE or PAUSED (budget spent)
+    */
+   Status search(long budget);
+
+   /**
+    * countSolutions
+    * Count the solutions of the Puzzle, up to a limit, by resuming
+    * search() after each one, so it prunes the same way as the solver.
+    * A limit of 2 checks that the solution is unique. The counters are
+    * those of the whole count.
+    * @param limit most solutions to count, at least 1
+    * @return number of solutions found, 0 - limit
+    * @post the Puzzle holds the first solution, if there is one
+    */
+   int countSolutions(int limit);
+
  private:
-   // Puzzle board, a 9x9 matrix of Squares
-   // maintained internally as a single dimension array
-   Square board[PUZZLE_SIZE];
-   // the 9 blocks associated with the Puzzle board
-   Block blocks[9] = 
-            {Block(board[BK_1]), Block(board[BK_2]), Block(board[BK_3]),
-             Block(board[BK_4]), Block(board[BK_5]), Block(board[BK_6]),
-             Block(board[BK_7]), Block(board[BK_8]), Block(board[BK_9])};
-   
+   // Puzzle board, a 9x9 (PUZZLE_DIM x PUZZLE_DIM) matrix of square
+   // values (0 - 9), maintained internally as a single dimension array
+   unsigned char board[PUZZLE_SIZE] = {};
+   // bit pos % 64 of word pos / 64 is set if the Square at pos is fixed
+   uint64_t fixedBits[(PUZZLE_SIZE + 63) / 64] = {};
+   // squares filled by propagate(), in order, to be erased on backtrack
+   Index trail[PUZZLE_SIZE];
+   int trailSize = 0;
+
+   // bit v is set if digit v is in the row, column or block
+   Mask rowMask[PUZZLE_DIM] = {};
+   Mask colMask[PUZZLE_DIM] = {};
+   Mask blockMask[PUZZLE_DIM] = {};
+
    int numVariable = 0; // number of non-fixed squares in Puzzle board
    int numEmpty = 0; // number of empty squares
    bool validInput = false; // was correct number of digits entered?
+   bool conflict = false; // does a digit appear twice in the input?
+   long nodes = 0; // number of digits placed by solve()
+   long guesses = 0; // nodes in a square with more than one legal digit
+   long forced = 0; // number of singles filled by propagate()
+#ifdef SUDOKU_STATS
+   long backtracks = 0; // digits erased after their subtree failed
+   long passes = 0; // passes of propagate() over the board
+   int level = 0; // digits placed by solve() above the current node
+   int maxDepth = 0; // most digits placed by the search above a node
+   double seconds = 0; // time in the calls made on this Puzzle
+#endif
+   bool mrv = false; // branch on the most constrained square?
+   bool propagation = false; // fill singles at each node?
+   bool hiddenSingles = true; // and hidden singles, not only naked ones?
+   bool simd = false; // count the legal digits of every square at once?
+   // set by solveParallel when another subtree has been solved
+   const std::atomic<bool>* cancel = nullptr;
+
+   /**
+    * A square search() has branched on.
+    */
+   struct Frame
+   {
+      Index pos; // the square, or PUZZLE_SIZE at a solution
+      Index mark; // trail size before the node was propagated
+      Mask candidates; // digits left to try, and GUESS_BIT
+   };
+   const static Mask GUESS_BIT = 1; // square had 2+ digits
+   Frame stack[PUZZLE_SIZE + 1]; // search() stack
+   int depth = -1; // frames on the stack; -1 before search() is called
+
+   /**
+    * setStats
+    * Set the counters, as getStats() returns them.
+    * @param stats the counters; those not kept without SUDOKU_STATS are
+    *   ignored
+    */
+   void setStats(const SolveStats& stats);
+
+   /**
+    * rowOf, colOf, blockOf
+    * Get the row, column or block (0 - 8, or 0 - PUZZLE_DIM - 1) of a
+    * position.
+    * Blocks are numbered left to right, top to bottom.
+    * @param pos Location of the Square in the Puzzle board
+    * @return row, column or block index
+    */
+   static int rowOf(int pos) { return pos / PUZZLE_DIM; }
+   static int colOf(int pos) { return pos % PUZZLE_DIM; }
+   static int blockOf(int pos) { return rowOf(pos) / BLOCK_DIM * BLOCK_DIM +
+                                        colOf(pos) / BLOCK_DIM; }
 
    /**
     * isValidRow
     * Determine if the new value would be valid for the row associated
     * with this position in the Puzzle board.
-    * row = pos / 9 (ie, PUZZLE_DIM)
+    * row = pos / PUZZLE_DIM
     * @param pos Location of the current Square in the Puzzle board to test
     * @param value The proposed new value to add to the current Square
     * @return true: adding this value would result in a valid Row;
     *   false: would not be valid.
     */
-   bool isValidRow(int pos, int value);
+   bool isValidRow(int pos, int value) const {
+                        return (rowMask[rowOf(pos)] & (1 << value)) == 0; }
 
    /**
     * isValidCol
     * Determine if the new value would be valid for the column associated
     * with this position in the Puzzle board.
-    * column = pos % 9 (ie, PUZZLE_DIM)
+    * column = pos % PUZZLE_DIM
     * @param pos Location of the current Square in the Puzzle board to test
     * @param value The proposed new value to add to the current Square
     * @return true: adding this value would result in a valid column;
     *   false: would not be valid.
     */
-   bool isValidCol(int pos, int value);
+   bool isValidCol(int pos, int value) const {
+                        return (colMask[colOf(pos)] & (1 << value)) == 0; }
+
+   /**
+    * isValidBlock
+    * Determine if the new value would be valid for the Block associated
+    * with this position in the Puzzle board.
+    * @param pos Location of the current Square in the Puzzle board to test
+    * @param value The proposed new value to add to the current Square
+    * @return true: adding this value would result in a valid Block;
+    *   false: would not be valid.
+    */
+   bool isValidBlock(int pos, int value) const {
+                    return (blockMask[blockOf(pos)] & (1 << value)) == 0; }
 
    /**
     * blocksAreValid
-    * Check of all the Blocks associated with the Puzzle board are valide.
-    * Proposed new value has already been set.
+    * Check of all the Blocks of the Puzzle board are valide.
+    * Rescans every Square; used only to check the bitmasks.
     * @return true: all blocks are valid; false: at least one is not valid.
     */
-   bool blocksAreValid();
+   bool blocksAreValid() const;
+
+   /**
+    * place
+    * Put value in the Square at pos, and add it to the bitmasks of the
+    * row, column and Block. Record a conflict if a bitmask already has
+    * the value.
+    * @param pos The index position of the Square in the Puzzle board.
+    * @param value The value to insert, 1 - PUZZLE_DIM.
+    */
+   void place(int pos, int value);
+
+   /**
+    * getCandidates
+    * Get the digits that are legal in a square: the digits not in its
+    * row, column or Block.
+    * @param pos Location of the Square in the Puzzle board
+    * @return bitmask with bit v set if digit v is legal
+    */
+   Mask getCandidates(int pos) const {
+      return ~(rowMask[rowOf(pos)] | colMask[colOf(pos)] |
+               blockMask[blockOf(pos)]) & ALL_DIGITS; }
+
+   /**
+    * getMostConstrainedPos
+    * Get the empty Square with the fewest legal digits (the first one,
+    * if there is a tie). Stops early at a Square with 0 or 1.
+    * @param count set to the number of legal digits of that Square
+    * @return The position of the Square, or PUZZLE_SIZE if none empty.
+    */
+   int getMostConstrainedPos(int& count) const;
+
+   /**
+    * isFixed
+    * @param pos Location of the Square in the Puzzle board
+    * @return true: the Square has an initial value; false: it does not
+    */
+   bool isFixed(int pos) const {
+                        return (fixedBits[pos / 64] >> (pos % 64)) & 1; }
+
+   /**
+    * branch
+    * Get the square solve() would branch on next, and its legal digits.
+    * @param pos first square to look at in scan order
+    * @param candidates set to the legal digits of the square
+    * @return Location of the Square, or PUZZLE_SIZE if none empty.
+    */
+   int branch(int pos, Mask& candidates) const;
+
+   /**
+    * enter
+    * Start a node of search(): propagate, then push a Frame for the
+    * square to branch on (or a solution Frame, if none is empty).
+    * @param pos first square to look at in scan order
+    * @return SOLVED; PAUSED if a Frame was pushed; UNSOLVABLE if
+    *   propagation found a dead end (its squares are erased again)
+    */
+   Status enter(int pos);
+
+   /**
+    * load
+    * Put the digits of a puzzle into the Puzzle board, and set the
+    * fixed, empty and variable Squares.
+    * @param digits PUZZLE_SIZE digits, 0 for an empty Square
+    * @pre The Puzzle is empty (default constructed).
+    */
+   void load(const std::string& digits);
+
+   /**
+    * unitPos
+    * Get a Square of a unit: one of the 9 rows (units 0 - 8), 9 columns
+    * (units 9 - 17) or 9 Blocks (units 18 - 26); PUZZLE_DIM of each on
+    * a larger board.
+    * @param unit unit index, 0 - 26
+    * @param k index of the Square in the unit, 0 - 8
+    * @return Location of the Square in the Puzzle board
+    */
+   static int unitPos(int unit, int k);
+
+   /**
+    * unitMask
+    * Get the digits used in a unit (see unitPos).
+    * @param unit unit index, 0 - 26
+    * @return bitmask with bit v set if digit v is in the unit
+    */
+   Mask unitMask(int unit) const;
+
+   /**
+    * propagate
+    * Fill naked and hidden singles until none are left. Each square filled
+    * is pushed on the trail.
+    * @return false if a square has no legal digit, or a digit has no legal
+    *   square in a unit (the Puzzle can't be solved); otherwise true
+    */
+   bool propagate();
+
+   /**
+    * force
+    * Fill a single found by propagate(), and push it on the trail.
+    * @param pos Location of the empty Square
+    * @param value its only legal digit
+    */
+   void force(int pos, int value);
+
+   /**
+    * undo
+    * Erase the squares filled by propagate() since the trail had mark
+    * entries.
+    * @param mark trail size to go back to
+    */
+   void undo(int mark);
 
    /**
     * getNextEmptySquarePos
@@ -177,30 +602,32 @@ public:
     * @return The position of the next empty Square, or PUZZLE_SIZE if
     * none remaining.
     */
-   int getNextEmptySquarePos(int pos);
+   int getNextEmptySquarePos(int pos) const;
 
    /**
     * setValue
     * Set the value of the Square at pos.
     * No checking of value 'validity'. Used by >> operator to directly write
-    * values in the Puzzle board.
+    * values in the Puzzle board. A value that is already in the row,
+    * column or Block is recorded as a conflict, and solve() will fail.
     * numVariable and numEmpty are not updated.
     * @param pos The index position of the Square in the Puzzle board.
     * @param value The value to insert.
     * @pre The Square value at pos is 0 (set by default constructor).
-    * @post The Square value at pos is set to value (0 - 9).
+    * @post The Square value at pos is set to value (0 - PUZZLE_DIM).
     */
-   void setValue(int pos, int value) { board[pos].setValue(value); }
+   void setValue(int pos, int value) { if (value != 0) place(pos, value); }
 
     /**
     * erase
-    * Erase (set to 0) the Square at position pos.
+    * Erase (set to 0) the Square at position pos, and remove its value
+    * from the bitmasks.
     * Increment numEmpty.
     * @param pos The index position of the Square in the Puzzle board.
-    * @pre The value at pos is a digit 0 - 9.
+    * @pre The value at pos is a digit 1 - PUZZLE_DIM.
     * @post The value at pos is set to 0.
    */
-   void erase(int pos) { board[pos].setValue(0); this->numEmpty++; }
+   void erase(int pos);
 
    /**
     * operator <<
@@ -210,18 +637,21 @@ public:
     * @param p Reference to Puzzle instance.
     * @output Reference to ostream after operation.
     */
-   friend std::ostream& operator<<(std::ostream& os, Puzzle& p);
+   friend std::ostream& operator<< <BOX>(std::ostream& os, BasicPuzzle& p);
 
    /**
     * operator >>
     * Overloaded input stream operator.
     * Accepts character input.
-    * Reads first 81 digits, then attempts to solve puzzle.
+    * Reads first 81 (PUZZLE_SIZE) digits, then attempts to solve puzzle.
     * If < 81 digits, do not alter puzzle, print error message.
     * If > 81 digits, only read the first 81.
     * @param is Reference to the input stream (istream&).
     * @param p Reference to the Puzzle instance.
     * @return Reference to istream after reading characters.
     */
-   friend std::istream& operator>>(std::istream& is, Puzzle& p);
-};
\ No newline at end of file
+   friend std::istream& operator>> <BOX>(std::istream& is, BasicPuzzle& p);
+};
+
+// the usual 9x9 Sudoku
+typedef BasicPuzzle<3> Puzzle;
\ No newline at end of file
@@ -0,0 +1,82 @@
+/**
+ * SolveStats.h
+ *
+ * struct SolveStats
+ * What a solver did on a puzzle, from BasicPuzzle::getStats() or
+ * BasicDancingLinks::getStats(). The nodes, guesses and forced digits are
+ * always counted. The backtracks, depth, propagation passes and time
+ * cost a little in the inner loops of the search. They are only kept
+ * when the solvers are built with -DSUDOKU_STATS, and are 0 otherwise
+ * (SolveStats::ENABLED tells which).
+ *
+ * SUDOKU_STAT(statement) compiles the statement only with SUDOKU_STATS,
+ * so a build without it has no trace of the extra counters.
+ */
+
+#pragma once
+
+#include <chrono>
+
+#ifdef SUDOKU_STATS
+#define SUDOKU_STAT(...) __VA_ARGS__
+#else
+#define SUDOKU_STAT(...)
+#endif
+
+struct SolveStats
+{
+#ifdef SUDOKU_STATS
+   static const bool ENABLED = true;
+#else
+   static const bool ENABLED = false; // only nodes, guesses and forced
+#endif
+
+   long nodes = 0; // digits placed by the search (rows tried by DLX)
+   long guesses = 0; // nodes in a square with more than one legal digit
+   long forced = 0; // singles filled by propagation
+   long backtracks = 0; // nodes whose subtree had no solution
+   int maxDepth = 0; // most nodes on a path from the root
+   long passes = 0; // passes of propagation over the board
+   double seconds = 0; // time spent solving
+};
+
+/**
+ * class StatTimer
+ * Adds the time from its construction to its destruction to a total,
+ * so a solver can time a call however it returns. With no total, it
+ * does not read the clock at all.
+ */
+class StatTimer
+{
+public:
+   /**
+    * Constructor.
+    * Start timing.
+    * @param total seconds to add the time to, or nullptr
+    */
+   explicit StatTimer(double* total) : total(total)
+   {
+      if (total != nullptr)
+         start = std::chrono::steady_clock::now();
+   }
+
+   /**
+    * destructor
+    * Add the time since the constructor to the total.
+    */
+   ~StatTimer()
+   {
+      if (total == nullptr)
+         return;
+      std::chrono::duration<double> time =
+         std::chrono::steady_clock::now() - start;
+      *total += time.count();
+   }
+
+   StatTimer(const StatTimer&) = delete;
+   StatTimer& operator=(const StatTimer&) = delete;
+
+private:
+   double* total;
+   std::chrono::steady_clock::time_point start;
+};
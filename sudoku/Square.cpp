@@ -3,9 +3,9 @@
  * Thurman Gillespy
  * 
  * This class represents an individual square in a Sudoku puzzle board.
- * The Square has a value (digits 0 - 9), and a boolean indicating
- * whether the Square is fixed (has an initial value which cannot be changed),
- * or not.
+ * The Square has a value (digits 0 - 9, or up to 25 on a larger board),
+ * and a boolean indicating whether the Square is fixed (has an initial
+ * value which cannot be changed), or not.
  */
 
 // all methods are defined in Square.h
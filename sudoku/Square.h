@@ -4,16 +4,19 @@
  * 11/8/17
  * 
  * This class represents an individual square in a Sudoku puzzle board.
- * The Square has a value (digits 0 - 9), and a boolean indicating
- * whether the Square is fixed (has an initial value which cannot be changed),
- * or not.
+ * The Square has a value (digits 0 - 9, or up to 25 on a larger board),
+ * and a boolean indicating whether the Square is fixed (has an initial
+ * value which cannot be changed), or not.
  */
 
 #pragma once
 
+template <int BOX> class BasicPuzzle;
+
 class Square
 {
-   friend class Puzzle; // Puzzle calls Square::setValue
+   // Puzzle calls Square::setValue
+   template <int BOX> friend class BasicPuzzle;
 
  public:
    /**
@@ -29,7 +32,7 @@ class Square
    
    /**
     * getValue
-    * get the value of the square [0...9]
+    * get the value of the square [0...9], or up to 25
     * @return int: the value of the square
     */
    int getValue() const { return this->value;}
@@ -51,7 +54,8 @@ class Square
  protected:
    /**
     * setValue
-    * Set the value of the square. Must be [0...9].
+    * Set the value of the square. Must be [0...9], or up to the number
+    * of digits of the Puzzle.
     * 0 means the square is empty.
     * No checking for value 'validity'.
     * @param value - new value for square
@@ -61,7 +65,7 @@ class Square
    void setValue(int value) { this->value = value; }
 
 private:
-   // the value of the square [0...9], 0 = empty
+   // the value of the square [0...9] (or more), 0 = empty
    int value;
    // is the value fixed, ie, set at game beginning
    bool isFixed;
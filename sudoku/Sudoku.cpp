@@ -4,17 +4,238 @@
  * 11/7/17
  * 
  * Program to solve Sudoko puzzles using the Puzzle class.
+ *
+ * Usage: sudoku [-b [-t threads] [-o csv | json]] [-j threads] [-i]
+ *               [-n nodes] [-s limit | -u] [-d size] [-m] [-p] [-v] [-x]
+ *               < puzzle.txt
+ *   -b   batch mode: solve one puzzle per line (81 characters, 0 or '.'
+ *        for an empty square), and print one line for each, in order:
+ *        the 81 digits of the solution, "unsolvable", "unfinished" (node
+ *        budget spent) or "invalid". The number of puzzles solved per
+ *        second is printed to stderr.
+ *   -t   number of threads solving puzzles in batch mode (default 1)
+ *   -o   in batch mode, print a record for each puzzle instead: its
+ *        number, its line as above and what the solver did (nodes,
+ *        guesses, forced digits, and with a solver built with
+ *        -DSUDOKU_STATS backtracks, depth, propagation passes and
+ *        seconds), as CSV with a header line, or one JSON object per
+ *        line
+ *   -j   search each puzzle on this many threads (subtrees of the search
+ *        tree solved at once); not used with -x. In batch mode, each of
+ *        the -t threads has its own pool of them, started once
+ *   -i   solve with the iterative search instead of the recursive solve
+ *   -n   give up on a puzzle after this many nodes (implies -i)
+ *   -s   count the solutions, up to limit, and print the number found;
+ *        in batch mode, each line is the number, then a space and the
+ *        first solution if there is one. Not used with -j or -n
+ *   -u   check that the solution is unique (same as -s 2)
+ *   -d   puzzles are size x size: 4, 9 (the default), 16 or 25, with
+ *        the digits 1 - 9 and then A - P; a line is size x size
+ *        characters
+ *   -m   branch on the square with the fewest legal digits (MRV)
+ *   -p   fill naked and hidden singles at each node (propagation)
+ *   -v   with -m or -p, count the legal digits of every square at once
+ *        (vector kernel when built with -mavx2, for 9x9)
+ *   -x   solve with dancing links (exact cover) instead
  */
 
+#include "DancingLinks.h"
 #include "Puzzle.h"
+#include "WorkStealingPool.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
 using namespace std;
 
+/**
+ * Solver settings from the command line.
+ */
+struct SudokuOptions
+{
+   bool batch = false; // one puzzle per line
+   bool mrv = false; // branch on the most constrained square
+   bool propagate = false; // fill singles at each node
+   bool simd = false; // count the legal digits of all squares at once
+   bool exactCover = false; // solve with DancingLinks
+   int threads = 1; // threads solving puzzles in batch mode
+   int searchThreads = 1; // threads searching each puzzle
+   bool iterative = false; // solve with Puzzle::search
+   long budget = 0; // most nodes for each puzzle, 0 for no limit
+   int limit = 0; // > 0: count solutions, up to this many
+   int size = 9; // squares on a side: 4, 9, 16 or 25
+   string format; // batch records: "csv" or "json"; "" for plain lines
+};
+
+// puzzle lines read and solved at a time in batch mode
+const size_t BATCH_LINES = 1 << 16;
+
+/**
+ * run
+ * Solve the puzzle on cin, or each line of cin in batch mode, on a
+ * board of BOX x BOX blocks.
+ * @param options solver settings
+ * @return exit status of the program
+ */
+template <int BOX>
+int run(const SudokuOptions& options);
+
+/**
+ * solvePuzzle
+ * Solve a Puzzle with the solver chosen by the options.
+ * @param p Puzzle to solve, loaded
+ * @param options solver settings
+ * @param dlx DancingLinks solver, used with -x
+ * @param search threads to search on with -j, or nullptr to start them
+ * @return SOLVED, UNSOLVABLE, or PAUSED if the node budget was spent
+ */
+template <int BOX>
+typename BasicPuzzle<BOX>::Status solvePuzzle(BasicPuzzle<BOX>& p,
+   const SudokuOptions& options, BasicDancingLinks<BOX>& dlx,
+   WorkStealingPool* search);
+
+/**
+ * countPuzzle
+ * Count the solutions of a Puzzle, up to options.limit, with the solver
+ * chosen by the options.
+ * @param p Puzzle to solve, loaded; set to the first solution
+ * @param options solver settings
+ * @param dlx DancingLinks solver, used with -x
+ * @return number of solutions found
+ */
+template <int BOX>
+int countPuzzle(BasicPuzzle<BOX>& p, const SudokuOptions& options,
+                BasicDancingLinks<BOX>& dlx);
+
+/**
+ * solveLine
+ * Solve the puzzle on one line.
+ * @param line puzzle line, without the newline
+ * @param options solver settings
+ * @param dlx DancingLinks solver, used with -x
+ * @param search threads to search on with -j, or nullptr to start them
+ * @param stats set to what the solver did
+ * @return the 81 digits of the solution, "unsolvable", "unfinished" if
+ *   the node budget was spent, or "invalid" if the line is not a puzzle;
+ *   when counting, the number of solutions and the first solution
+ */
+template <int BOX>
+string solveLine(const string& line, const SudokuOptions& options,
+                 BasicDancingLinks<BOX>& dlx, WorkStealingPool* search,
+                 SolveStats& stats);
+
+/**
+ * writeRecord
+ * Print the result of one puzzle and what the solver did, as a CSV line
+ * or a JSON object on one line.
+ * @param os output stream
+ * @param number puzzle number, from 1
+ * @param result the line solveLine returned
+ * @param stats what the solver did
+ * @param format "csv" or "json"
+ */
+void writeRecord(ostream& os, long number, const string& result,
+                 const SolveStats& stats, const string& format);
+
+/**
+ * solveBatch
+ * Solve one puzzle per line of is, and print one line for each to os.
+ * @param is puzzle lines
+ * @param os solution lines
+ * @param options solver settings
+ * @return number of puzzles solved
+ */
+template <int BOX>
+long solveBatch(istream& is, ostream& os, const SudokuOptions& options);
+
 int main(int argc, const char * argv[])
 {
+   SudokuOptions options;
+
+   // options
+   for (int i = 1; i < argc; i++)
+   {
+      string arg = argv[i];
+      if (arg == "-b")
+         options.batch = true;
+      else if (arg == "-m")
+         options.mrv = true;
+      else if (arg == "-p")
+         options.propagate = true;
+      else if (arg == "-v")
+         options.simd = true;
+      else if (arg == "-x")
+         options.exactCover = true;
+      else if (arg == "-t" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+         options.threads = atoi(argv[++i]);
+      else if (arg == "-j" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+         options.searchThreads = atoi(argv[++i]);
+      else if (arg == "-i")
+         options.iterative = true;
+      else if (arg == "-n" && i + 1 < argc && atol(argv[i + 1]) > 0)
+      {
+         options.iterative = true;
+         options.budget = atol(argv[++i]);
+      }
+      else if (arg == "-s" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+         options.limit = atoi(argv[++i]);
+      else if (arg == "-u")
+         options.limit = 2;
+      else if (arg == "-d" && i + 1 < argc)
+         options.size = atoi(argv[++i]);
+      else if (arg == "-o" && i + 1 < argc)
+      {
+         options.format = argv[++i];
+         if (options.format != "csv" && options.format != "json")
+            options.size = 0; // print the usage
+      }
+      else
+         options.size = 0; // print the usage
+   }
+
+   switch (options.size)
+   {
+   case 4:
+      return run<2>(options);
+   case 9:
+      return run<3>(options);
+   case 16:
+      return run<4>(options);
+   case 25:
+      return run<5>(options);
+   }
+   cout << "Usage: sudoku [-b [-t threads] [-o csv | json]] [-j threads] ";
+   cout << "[-i]" << endl;
+   cout << "              [-n nodes] [-s limit | -u] [-d size] [-m] [-p] ";
+   cout << "[-v] [-x]" << endl;
+   cout << "              < puzzle.txt" << endl;
+   return 1;
+}
+
+/**
+ * run
+ * Solve the puzzle on cin, or each line of cin in batch mode, on a
+ * board of BOX x BOX blocks, and print the result.
+ * @param options solver settings
+ * @return exit status of the program
+ */
+template <int BOX>
+int run(const SudokuOptions& options)
+{
+   typedef BasicPuzzle<BOX> Puzzle;
    Puzzle p;
-   bool solved = false;
+   typename Puzzle::Status solved = Puzzle::UNSOLVABLE;
+
+   if (options.batch)
+   {
+      solveBatch<BOX>(cin, cout, options);
+      return 0;
+   }
 
    // load the puzzle
    cin >> p;
@@ -28,9 +249,30 @@ int main(int argc, const char * argv[])
 
    // print the puzzle before solving
    cout << p;
-   solved = p.solve(0);
+   // heap: the 25x25 links are too big for the stack
+   unique_ptr<BasicDancingLinks<BOX> > dlx(new BasicDancingLinks<BOX>);
+   if (options.limit > 0)
+   {
+      int count = countPuzzle(p, options, *dlx);
+      if (count == 0)
+      {
+         cout << "the puzzle could not be solved" << endl << endl;
+         return 0;
+      }
+      cout << p;
+      cout << "the puzzle has " << (count < options.limit ? "" : "at least ");
+      cout << count << (count == 1 ? " solution" : " solutions") << endl;
+      return 0;
+   }
+   solved = solvePuzzle(p, options, *dlx, nullptr);
    // exit if cannot be solved
-   if (!solved)
+   if (solved == Puzzle::PAUSED)
+   {
+      cout << "the puzzle was not solved in " << options.budget;
+      cout << " nodes" << endl << endl;
+      return 0;
+   }
+   if (solved != Puzzle::SOLVED)
    {
       cout << "the puzzle could not be solved" << endl << endl;
       return 0;
@@ -39,4 +281,244 @@ int main(int argc, const char * argv[])
    cout << p;
 
    return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * solvePuzzle
+ * Solve a Puzzle with the solver chosen by the options.
+ * @param p Puzzle to solve, loaded
+ * @param options solver settings
+ * @param dlx DancingLinks solver, used with -x
+ * @param search threads to search on with -j, or nullptr to start them
+ * @return SOLVED, UNSOLVABLE, or PAUSED if the node budget was spent
+ */
+template <int BOX>
+typename BasicPuzzle<BOX>::Status solvePuzzle(BasicPuzzle<BOX>& p,
+   const SudokuOptions& options, BasicDancingLinks<BOX>& dlx,
+   WorkStealingPool* search)
+{
+   typedef BasicPuzzle<BOX> Puzzle;
+   bool solved;
+   if (options.exactCover)
+      solved = dlx.solve(p);
+   else
+   {
+      p.setMRV(options.mrv);
+      p.setPropagate(options.propagate);
+      p.setSimd(options.simd);
+      if (options.iterative)
+         return p.search(options.budget);
+      if (search != nullptr)
+         solved = p.solveParallel(*search);
+      else if (options.searchThreads > 1)
+         solved = p.solveParallel(options.searchThreads);
+      else
+         solved = p.solve(0);
+   }
+   return solved ? Puzzle::SOLVED : Puzzle::UNSOLVABLE;
+}
+
+/**
+ * countPuzzle
+ * Count the solutions of a Puzzle, up to options.limit, with the solver
+ * chosen by the options: DancingLinks, or the iterative search.
+ * @param p Puzzle to solve, loaded; set to the first solution
+ * @param options solver settings
+ * @param dlx DancingLinks solver, used with -x
+ * @return number of solutions found
+ */
+template <int BOX>
+int countPuzzle(BasicPuzzle<BOX>& p, const SudokuOptions& options,
+                BasicDancingLinks<BOX>& dlx)
+{
+   if (options.exactCover)
+      return dlx.countSolutions(p, options.limit);
+   p.setMRV(options.mrv);
+   p.setPropagate(options.propagate);
+   p.setSimd(options.simd);
+   return p.countSolutions(options.limit);
+}
+
+/**
+ * solveLine
+ * Solve the puzzle on one line, with a fresh Puzzle.
+ * @param line puzzle line, without the newline
+ * @param options solver settings
+ * @param dlx DancingLinks solver, used with -x
+ * @param search threads to search on with -j, or nullptr to start them
+ * @param stats set to what the solver did
+ * @return the 81 digits of the solution, "unsolvable", "unfinished" if
+ *   the node budget was spent, or "invalid" if the line is not a puzzle;
+ *   when counting, the number of solutions and the first solution
+ */
+template <int BOX>
+string solveLine(const string& line, const SudokuOptions& options,
+                 BasicDancingLinks<BOX>& dlx, WorkStealingPool* search,
+                 SolveStats& stats)
+{
+   typedef BasicPuzzle<BOX> Puzzle;
+   Puzzle p;
+   stats = SolveStats();
+   if (!p.read(line))
+      return "invalid";
+   if (options.limit > 0)
+   {
+      int count = countPuzzle(p, options, dlx);
+      stats = options.exactCover ? dlx.getStats() : p.getStats();
+      ostringstream out;
+      out << count;
+      if (count > 0)
+      {
+         out << ' ';
+         p.write(out);
+      }
+      return out.str();
+   }
+   typename Puzzle::Status status = solvePuzzle(p, options, dlx, search);
+   stats = options.exactCover ? dlx.getStats() : p.getStats();
+   if (status == Puzzle::PAUSED)
+      return "unfinished";
+   if (status == Puzzle::UNSOLVABLE)
+      return "unsolvable";
+   ostringstream out;
+   p.write(out);
+   return out.str();
+}
+
+/**
+ * solveBatch
+ * Solve one puzzle per line of is, and print one line for each to os,
+ * in the same order: see solveLine.
+ * Lines are read BATCH_LINES at a time, and solved on a
+ * WorkStealingPool, so a hard puzzle holds up only the thread solving
+ * it. Each thread has its own DancingLinks, and with -j its own pool to
+ * search each puzzle on, started once. With options.format, each
+ * line is a record instead (see writeRecord). The time taken and the
+ * puzzles solved per second are printed to cerr, and when counting
+ * solutions, the number of puzzles with exactly one.
+ * @param is puzzle lines
+ * @param os solution lines
+ * @param options solver settings
+ * @return number of puzzles solved
+ */
+template <int BOX>
+long solveBatch(istream& is, ostream& os, const SudokuOptions& options)
+{
+   const size_t PUZZLE_SIZE = BOX * BOX * BOX * BOX;
+   ios::sync_with_stdio(false);
+   WorkStealingPool pool(options.threads);
+   vector<BasicDancingLinks<BOX> > dlx(pool.size());
+   vector<long> solvedBy(pool.size(), 0); // puzzles solved by each thread
+   vector<long> uniqueBy(pool.size(), 0); // with one solution, counting
+   vector<unique_ptr<WorkStealingPool> > search(pool.size()); // with -j
+   for (size_t t = 0; options.searchThreads > 1 && t < search.size(); t++)
+      search[t].reset(new WorkStealingPool(options.searchThreads));
+   vector<string> lines;
+   vector<string> results;
+   vector<SolveStats> stats;
+   string line;
+   long count = 0;
+
+   if (options.format == "csv")
+   {
+      os << "puzzle,result,nodes,guesses,forced";
+      if (SolveStats::ENABLED)
+         os << ",backtracks,max_depth,passes,seconds";
+      os << '\n';
+   }
+
+   auto start = chrono::steady_clock::now();
+   while (true)
+   {
+      lines.clear();
+      while (lines.size() < BATCH_LINES && getline(is, line))
+      {
+         if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+         lines.push_back(line);
+      }
+      if (lines.empty())
+         break;
+
+      results.assign(lines.size(), "");
+      stats.assign(lines.size(), SolveStats());
+      pool.run(lines.size(), [&](size_t i, int worker) {
+         results[i] = solveLine(lines[i], options, dlx[worker],
+                                search[worker].get(), stats[i]);
+         if (results[i].length() >= PUZZLE_SIZE)
+            solvedBy[worker]++;
+         if (options.limit > 1 && results[i].compare(0, 2, "1 ") == 0)
+            uniqueBy[worker]++;
+      });
+
+      for (size_t i = 0; i < results.size(); i++)
+      {
+         if (options.format.empty())
+            os << results[i] << '\n';
+         else
+            writeRecord(os, count + i + 1, results[i], stats[i],
+                        options.format);
+      }
+      count += lines.size();
+   }
+   os.flush();
+   chrono::duration<double> time = chrono::steady_clock::now() - start;
+
+   long solved = 0;
+   long unique = 0;
+   for (size_t t = 0; t < solvedBy.size(); t++)
+   {
+      solved += solvedBy[t];
+      unique += uniqueBy[t];
+   }
+   cerr << "solved " << solved << " of " << count << " puzzles";
+   if (options.limit > 1)
+      cerr << " (" << unique << " unique)";
+   // the rate is formatted apart, so cerr keeps its default format
+   ostringstream rate;
+   rate << fixed << setprecision(1) << count / time.count();
+   cerr << " in ";
+   cerr << time.count() << " s (" << rate.str() << " puzzles/s)" << endl;
+   return solved;
+}
+
+/**
+ * writeRecord
+ * Print the result of one puzzle and what the solver did, as a CSV line
+ * (the columns of the header solveBatch prints) or a JSON object on one
+ * line. The counters kept only with SUDOKU_STATS are left out without
+ * it.
+ * @param os output stream
+ * @param number puzzle number, from 1
+ * @param result the line solveLine returned
+ * @param stats what the solver did
+ * @param format "csv" or "json"
+ */
+void writeRecord(ostream& os, long number, const string& result,
+                 const SolveStats& stats, const string& format)
+{
+   bool json = format == "json";
+   const char* names[] = {"nodes", "guesses", "forced", "backtracks",
+                          "max_depth", "passes"};
+   long values[] = {stats.nodes, stats.guesses, stats.forced,
+                    stats.backtracks, stats.maxDepth, stats.passes};
+   int fields = SolveStats::ENABLED ? 6 : 3;
+
+   if (json)
+      os << "{\"puzzle\":" << number << ",\"result\":\"" << result << '"';
+   else
+      os << number << ',' << result;
+   for (int f = 0; f < fields; f++)
+   {
+      os << ',';
+      if (json)
+         os << '"' << names[f] << "\":";
+      os << values[f];
+   }
+   if (SolveStats::ENABLED)
+   {
+      os << (json ? ",\"seconds\":" : ",");
+      os << fixed << setprecision(9) << stats.seconds;
+   }
+   os << (json ? "}\n" : "\n");
+}
@@ -0,0 +1,604 @@
+/**
+ * SudokuBench.cpp
+ *
+ * Solver benchmark for the Puzzle class.
+ *
+ * Each puzzle file has one puzzle per line: 81 characters, the digits
+ * 1 - 9 for given squares and 0 or '.' for empty squares. Every puzzle
+ * is solved, and one line is printed for it with the number of search
+ * tree nodes (digits placed by solve), the guesses (nodes in a square
+ * with more than one legal digit), the singles filled by propagation, the
+ * time and the nodes per second, then a total line for each file with the
+ * number of puzzles solved without a guess.
+ *
+ * With -i, puzzles are solved with the iterative Puzzle::search, and with
+ * -n, the search is paused every budget nodes and resumed until done; the
+ * number of pauses is printed with the total.
+ *
+ * With -s or -u, the solutions of each puzzle are counted, up to a
+ * limit, and the number found is printed after its line; the total line
+ * has the number of puzzles with exactly one solution.
+ *
+ * With -c, the size of a Puzzle and the time to copy one are printed
+ * instead; with -k, the time to count the legal digits of every square
+ * (Puzzle::getCandidateCounts) with the scalar loop and the vector kernel.
+ *
+ * With -t, the puzzles of all the files, repeated -r times, are instead
+ * solved as one batch on a WorkStealingPool of 1, 2, ... threads, with
+ * and without stealing, and one line is printed for each thread count.
+ *
+ * Usage: sudoku_bench [-m] [-p] [-v] [-x] [-j threads] [-i] [-n nodes]
+ *                     [-s limit | -u] [-t threads [-r repeat]] [-c | -k]
+ *                     [-d size] <puzzles.txt> [puzzles.txt ...]
+ *   -m   branch on the square with the fewest legal digits (MRV)
+ *   -p   fill naked and hidden singles at each node (propagation)
+ *   -v   with -m or -p, count the legal digits of every square at once
+ *        (vector kernel when built with -mavx2, for 9x9)
+ *   -x   solve with dancing links (exact cover); nodes are the rows
+ *        tried, and forced digits are not counted
+ *   -j   search each puzzle on this many threads (not used with -x)
+ *   -i   solve with the iterative search instead of the recursive solve
+ *   -n   node budget of each call to the iterative search (implies -i)
+ *   -s   count the solutions of each puzzle, up to limit (not used with
+ *        -j or -n)
+ *   -u   check that each solution is unique (same as -s 2)
+ *   -t   batch scaling benchmark, up to this many threads
+ *   -r   number of times the puzzles are repeated in the batch
+ *   -c   Puzzle copy benchmark
+ *   -k   candidate count kernel benchmark
+ *   -d   puzzles are size x size: 4, 9 (the default), 16 or 25, with
+ *        the digits 1 - 9 and then A - P
+ */
+
+#include "DancingLinks.h"
+#include "Puzzle.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Solver settings from the command line.
+ */
+struct BenchOptions
+{
+   bool mrv = false; // branch on the most constrained square
+   bool propagate = false; // fill singles at each node
+   bool simd = false; // count the legal digits of all squares at once
+   bool exactCover = false; // solve with DancingLinks
+   int threads = 0; // > 0: batch scaling benchmark up to this many threads
+   int searchThreads = 1; // threads searching each puzzle
+   int repeat = 1; // times the puzzles are repeated in the batch
+   bool copy = false; // Puzzle copy benchmark
+   bool kernel = false; // candidate count kernel benchmark
+   bool iterative = false; // solve with Puzzle::search
+   long budget = 0; // nodes searched between pauses, 0 for no pauses
+   int limit = 0; // > 0: count solutions, up to this many
+   int size = 9; // squares on a side: 4, 9, 16 or 25
+};
+
+/**
+ * run
+ * Run the benchmark chosen by the options on puzzles of BOX x BOX
+ * blocks.
+ * @param fileNames puzzle files, one puzzle per line
+ * @param options solver settings
+ * @return exit status of the program
+ */
+template <int BOX>
+int run(const vector<string>& fileNames, const BenchOptions& options);
+
+/**
+ * benchFile
+ * Solve every puzzle in a file, and print the nodes and time of each.
+ * @param fileName puzzle file, one puzzle per line
+ * @param options solver settings
+ * @return false if the file could not be read or a puzzle was not
+ *   solved, otherwise true
+ */
+template <int BOX>
+bool benchFile(const string& fileName, const BenchOptions& options);
+
+/**
+ * benchScaling
+ * Solve the puzzles of all the files as one batch, on 1 to
+ * options.threads threads, and print the time of each.
+ * @param fileNames puzzle files, one puzzle per line
+ * @param options solver settings
+ * @return false if a file could not be read or a puzzle was not
+ *   solved, otherwise true
+ */
+template <int BOX>
+bool benchScaling(const vector<string>& fileNames,
+                  const BenchOptions& options);
+
+/**
+ * solve
+ * Solve a loaded Puzzle with the solver chosen by the options.
+ * @param p Puzzle to solve
+ * @param options solver settings
+ * @param dlx DancingLinks solver, used with -x
+ * @param pauses incremented each time the iterative search is paused
+ * @return number of solutions found: 0 or 1, or up to options.limit
+ *   when counting
+ */
+template <int BOX>
+int solve(BasicPuzzle<BOX>& p, const BenchOptions& options,
+          BasicDancingLinks<BOX>& dlx, long& pauses);
+
+/**
+ * benchCopy
+ * Print the size of a Puzzle, and the time to copy one, loaded with the
+ * first puzzle of a file.
+ * @param fileName puzzle file, one puzzle per line
+ * @return false if the file has no puzzle, otherwise true
+ */
+template <int BOX>
+bool benchCopy(const string& fileName);
+
+/**
+ * benchKernel
+ * Print the time to count the legal digits of every square of each
+ * puzzle in a file, with the scalar loop and with the vector kernel.
+ * @param fileName puzzle file, one puzzle per line
+ * @return false if the file has no puzzle or the two counts differ,
+ *   otherwise true
+ */
+template <int BOX>
+bool benchKernel(const string& fileName);
+
+/**
+ * threadTime
+ * @return CPU time used by the calling thread, in seconds
+ */
+double threadTime();
+
+int main(int argc, const char * argv[])
+{
+   BenchOptions options;
+   int first = 1; // first file name argument
+   for (; first < argc && argv[first][0] == '-'; first++)
+   {
+      string arg = argv[first];
+      if (arg == "-m")
+         options.mrv = true;
+      else if (arg == "-p")
+         options.propagate = true;
+      else if (arg == "-v")
+         options.simd = true;
+      else if (arg == "-x")
+         options.exactCover = true;
+      else if (arg == "-t" && first + 1 < argc && atoi(argv[first + 1]) > 0)
+         options.threads = atoi(argv[++first]);
+      else if (arg == "-r" && first + 1 < argc && atoi(argv[first + 1]) > 0)
+         options.repeat = atoi(argv[++first]);
+      else if (arg == "-j" && first + 1 < argc && atoi(argv[first + 1]) > 0)
+         options.searchThreads = atoi(argv[++first]);
+      else if (arg == "-c")
+         options.copy = true;
+      else if (arg == "-k")
+         options.kernel = true;
+      else if (arg == "-i")
+         options.iterative = true;
+      else if (arg == "-n" && first + 1 < argc && atol(argv[first + 1]) > 0)
+      {
+         options.iterative = true;
+         options.budget = atol(argv[++first]);
+      }
+      else if (arg == "-s" && first + 1 < argc && atoi(argv[first + 1]) > 0)
+         options.limit = atoi(argv[++first]);
+      else if (arg == "-u")
+         options.limit = 2;
+      else if (arg == "-d" && first + 1 < argc)
+         options.size = atoi(argv[++first]);
+      else
+         break;
+   }
+   bool sizeOk = options.size == 4 || options.size == 9 ||
+                 options.size == 16 || options.size == 25;
+   if (first >= argc || argv[first][0] == '-' || !sizeOk)
+   {
+      cout << "Usage: sudoku_bench [-m] [-p] [-v] [-x] [-j threads] [-i] ";
+      cout << "[-n nodes]" << endl;
+      cout << "                    [-s limit | -u] [-t threads [-r repeat]] ";
+      cout << "[-c | -k]" << endl;
+      cout << "                    [-d size] <puzzles.txt> [puzzles.txt ...]";
+      cout << endl;
+      return 1;
+   }
+
+   vector<string> fileNames(argv + first, argv + argc);
+   switch (options.size)
+   {
+   case 4:
+      return run<2>(fileNames, options);
+   case 16:
+      return run<4>(fileNames, options);
+   case 25:
+      return run<5>(fileNames, options);
+   }
+   return run<3>(fileNames, options);
+}
+
+/**
+ * run
+ * Run the benchmark chosen by the options on puzzles of BOX x BOX
+ * blocks: batch scaling, Puzzle copies, the candidate count kernel, or
+ * each file.
+ * @param fileNames puzzle files, one puzzle per line
+ * @param options solver settings
+ * @return exit status of the program
+ */
+template <int BOX>
+int run(const vector<string>& fileNames, const BenchOptions& options)
+{
+   if (options.threads > 0)
+      return benchScaling<BOX>(fileNames, options) ? 0 : 1;
+
+   bool ok = true;
+   for (size_t i = 0; i < fileNames.size(); i++)
+   {
+      if (options.copy)
+         ok = benchCopy<BOX>(fileNames[i]) && ok;
+      else if (options.kernel)
+         ok = benchKernel<BOX>(fileNames[i]) && ok;
+      else
+         ok = benchFile<BOX>(fileNames[i], options) && ok;
+   }
+   return ok ? 0 : 1;
+}
+
+/**
+ * benchFile
+ * Solve every puzzle in a file, and print the nodes and time of each.
+ * Lines that are not puzzles are skipped.
+ * @param fileName puzzle file, one puzzle per line
+ * @param options solver settings
+ * @return false if the file could not be read or a puzzle was not
+ *   solved, otherwise true
+ */
+template <int BOX>
+bool benchFile(const string& fileName, const BenchOptions& options)
+{
+   ifstream fin(fileName);
+   if (fin.fail())
+   {
+      cout << "Could not open <" << fileName << ">" << endl;
+      return false;
+   }
+
+   cout << fileName << endl;
+   cout << "puzzle        nodes    guesses     forced     time(ms)";
+   cout << "      nodes/s" << endl;
+
+   // heap: the 25x25 links are too big for the stack
+   unique_ptr<BasicDancingLinks<BOX> > dlx(new BasicDancingLinks<BOX>);
+   string line;
+   int count = 0;
+   long totalNodes = 0;
+   long totalGuesses = 0;
+   long totalForced = 0;
+   int noGuess = 0; // puzzles solved without a guess
+   double totalTime = 0;
+   long pauses = 0; // pauses of the iterative search
+   int unique = 0; // puzzles with one solution, when counting
+   bool ok = true;
+   while (getline(fin, line))
+   {
+      if (!line.empty() && line.back() == '\r')
+         line.pop_back();
+      BasicPuzzle<BOX> p;
+      if (!p.read(line))
+         continue;
+      auto start = chrono::steady_clock::now();
+      int found = solve(p, options, *dlx, pauses);
+      bool solved = found > 0;
+      chrono::duration<double> time = chrono::steady_clock::now() - start;
+      if (!solved)
+         ok = false;
+
+      long nodes = options.exactCover ? dlx->getNodes() : p.getNodes();
+      long guesses = options.exactCover ? dlx->getGuesses() :
+                                          p.getGuesses();
+      count++;
+      totalNodes += nodes;
+      totalGuesses += guesses;
+      totalForced += p.getForced();
+      totalTime += time.count();
+      if (solved && guesses == 0)
+         noGuess++;
+      cout << setw(6) << count << setw(13) << nodes;
+      cout << setw(11) << guesses << setw(11) << p.getForced();
+      cout << fixed << setprecision(3) << setw(13) << time.count() * 1e3;
+      cout << setprecision(0) << setw(13) << nodes / time.count();
+      cout << (solved ? "" : "  not solved");
+      if (options.limit > 0 && solved)
+      {
+         cout << "  " << (found < options.limit ? "" : ">= ") << found;
+         cout << (found == 1 ? " solution" : " solutions");
+      }
+      cout << endl;
+      if (found == 1 && options.limit > 1)
+         unique++;
+   }
+
+   cout << " total" << setw(13) << totalNodes << setw(11) << totalGuesses;
+   cout << setw(11) << totalForced << fixed << setprecision(3);
+   cout << setw(13) << totalTime * 1e3 << setprecision(0);
+   cout << setw(13) << totalNodes / totalTime << endl;
+   cout << noGuess << " of " << count << " solved without a guess";
+   if (options.budget > 0)
+      cout << ", " << pauses << " pauses";
+   if (options.limit > 1)
+      cout << ", " << unique << " with one solution";
+   cout << endl << endl;
+   return ok;
+}
+
+/**
+ * benchScaling
+ * Solve the puzzles of all the files as one batch, on 1 to
+ * options.threads threads, and print the time of each: first with each
+ * thread solving a fixed share of the batch (static partitioning), then
+ * with work stealing. The speedup is against work stealing on 1 thread.
+ * The CPU time of the busiest thread is printed too: it is the time the
+ * batch would take with a core for each thread, even on fewer cores.
+ * @param fileNames puzzle files, one puzzle per line
+ * @param options solver settings
+ * @return false if a file could not be read or a puzzle was not
+ *   solved, otherwise true
+ */
+template <int BOX>
+bool benchScaling(const vector<string>& fileNames,
+                  const BenchOptions& options)
+{
+   vector<string> puzzles;
+   for (size_t f = 0; f < fileNames.size(); f++)
+   {
+      ifstream fin(fileNames[f]);
+      if (fin.fail())
+      {
+         cout << "Could not open <" << fileNames[f] << ">" << endl;
+         return false;
+      }
+      string line;
+      while (getline(fin, line))
+      {
+         if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+         BasicPuzzle<BOX> p;
+         if (p.read(line))
+            puzzles.push_back(line);
+      }
+   }
+   vector<string> batch;
+   for (int r = 0; r < options.repeat; r++)
+      batch.insert(batch.end(), puzzles.begin(), puzzles.end());
+
+   cout << batch.size() << " puzzles" << endl;
+   cout << "threads    static(s)  busiest(s)     steal(s)  busiest(s)";
+   cout << "   puzzles/s  speedup   steals" << endl;
+
+   bool ok = true;
+   double base = 0; // time with stealing on 1 thread
+   for (int t = 1; t <= options.threads; t++)
+   {
+      cout << setw(7) << t;
+      for (int stealing = 0; stealing <= 1; stealing++)
+      {
+         WorkStealingPool pool(t);
+         pool.setStealing(stealing == 1);
+         vector<BasicDancingLinks<BOX> > dlx(pool.size());
+         vector<long> unsolved(pool.size(), 0);
+         vector<long> pauses(pool.size(), 0);
+         vector<double> busy(pool.size(), 0); // CPU time of each thread
+
+         auto start = chrono::steady_clock::now();
+         pool.run(batch.size(), [&](size_t i, int worker) {
+            double cpu = threadTime();
+            BasicPuzzle<BOX> p;
+            p.read(batch[i]);
+            if (!solve(p, options, dlx[worker], pauses[worker]))
+               unsolved[worker]++;
+            busy[worker] += threadTime() - cpu;
+         });
+         chrono::duration<double> time = chrono::steady_clock::now() - start;
+
+         double busiest = 0;
+         for (int w = 0; w < pool.size(); w++)
+         {
+            ok = ok && unsolved[w] == 0;
+            busiest = max(busiest, busy[w]);
+         }
+         if (stealing == 1 && t == 1)
+            base = time.count();
+         cout << fixed << setprecision(3) << setw(13) << time.count();
+         cout << setw(12) << busiest;
+         if (stealing == 1)
+         {
+            cout << setprecision(0) << setw(12) << batch.size() / time.count();
+            cout << setprecision(2) << setw(9) << base / time.count();
+            cout << setw(9) << pool.getSteals();
+         }
+      }
+      cout << endl;
+   }
+   return ok;
+}
+
+/**
+ * benchCopy
+ * Print the size of a Puzzle, and the time to copy one, loaded with the
+ * first puzzle of a file. The copies go round a ring of Puzzles, so they
+ * can't be optimized away.
+ * @param fileName puzzle file, one puzzle per line
+ * @return false if the file has no puzzle, otherwise true
+ */
+template <int BOX>
+bool benchCopy(const string& fileName)
+{
+   typedef BasicPuzzle<BOX> Puzzle;
+   const int RING = 64;
+   const long COPIES = 10000000;
+
+   ifstream fin(fileName);
+   string line;
+   Puzzle p;
+   while (getline(fin, line))
+   {
+      if (!line.empty() && line.back() == '\r')
+         line.pop_back();
+      if (p.read(line))
+         break;
+   }
+   if (!p.getValidInput())
+   {
+      cout << "No puzzle in <" << fileName << ">" << endl;
+      return false;
+   }
+
+   vector<Puzzle> ring(RING);
+   auto start = chrono::steady_clock::now();
+   for (long i = 0; i < COPIES; i++)
+      ring[i % RING] = p;
+   chrono::duration<double> time = chrono::steady_clock::now() - start;
+
+   long empty = 0;
+   for (int i = 0; i < RING; i++)
+      empty += ring[i].getNumEmpty();
+   cout << "sizeof(Puzzle) " << sizeof(Puzzle) << " bytes, copy ";
+   cout << fixed << setprecision(1) << time.count() / COPIES * 1e9;
+   cout << " ns (" << empty / RING << " empty squares)" << endl;
+   return true;
+}
+
+/**
+ * benchKernel
+ * Print the time to count the legal digits of every square of each
+ * puzzle in a file (as loaded), with the scalar loop and with the vector
+ * kernel, and check that the two agree. Each puzzle is counted many
+ * times, and the least counts are summed into a volatile, so the calls
+ * can't be optimized away.
+ * @param fileName puzzle file, one puzzle per line
+ * @return false if the file has no puzzle or the two counts differ,
+ *   otherwise true
+ */
+template <int BOX>
+bool benchKernel(const string& fileName)
+{
+   typedef BasicPuzzle<BOX> Puzzle;
+   const int SIZE = BOX * BOX * BOX * BOX; // squares
+   const long CALLS = 2000000; // calls of each kind, over all puzzles
+
+   ifstream fin(fileName);
+   string line;
+   vector<Puzzle> puzzles;
+   while (getline(fin, line))
+   {
+      if (!line.empty() && line.back() == '\r')
+         line.pop_back();
+      Puzzle p;
+      if (p.read(line))
+         puzzles.push_back(p);
+   }
+   if (puzzles.empty())
+   {
+      cout << "No puzzle in <" << fileName << ">" << endl;
+      return false;
+   }
+
+   unsigned char counts[2][SIZE];
+   uint64_t fewBits[2][Puzzle::FEW_WORDS];
+   bool same = true;
+   for (size_t i = 0; i < puzzles.size(); i++)
+   {
+      int least[2];
+      for (int simd = 0; simd <= 1; simd++)
+         least[simd] = puzzles[i].getCandidateCounts(counts[simd],
+                                                     fewBits[simd], simd);
+      same = same && least[0] == least[1] &&
+             equal(counts[0], counts[0] + SIZE, counts[1]) &&
+             equal(fewBits[0], fewBits[0] + Puzzle::FEW_WORDS, fewBits[1]);
+   }
+
+   long repeat = max(1L, CALLS / (long) puzzles.size());
+   double ns[2];
+   volatile long sum = 0;
+   for (int simd = 0; simd <= 1; simd++)
+   {
+      auto start = chrono::steady_clock::now();
+      long least = 0;
+      for (long r = 0; r < repeat; r++)
+      {
+         for (size_t i = 0; i < puzzles.size(); i++)
+            least += puzzles[i].getCandidateCounts(counts[simd],
+                                                   fewBits[simd], simd);
+      }
+      sum = sum + least;
+      chrono::duration<double> time = chrono::steady_clock::now() - start;
+      ns[simd] = time.count() / (repeat * puzzles.size()) * 1e9;
+   }
+
+   cout << fileName << ": " << puzzles.size() << " puzzles, scalar ";
+   cout << fixed << setprecision(1) << ns[0] << " ns, vector ";
+   cout << ns[1] << " ns" << (Puzzle::hasSimd() ? "" : " (no kernel)");
+   cout << ", speedup " << setprecision(2) << ns[0] / ns[1];
+   cout << (same ? "" : "  counts differ") << endl;
+   return same;
+}
+
+/**
+ * solve
+ * Solve a loaded Puzzle with the solver chosen by the options.
+ * @param p Puzzle to solve
+ * @param options solver settings
+ * @param dlx DancingLinks solver, used with -x
+ * @param pauses incremented each time the iterative search is paused
+ * @return number of solutions found: 0 or 1, or up to options.limit
+ *   when counting
+ */
+template <int BOX>
+int solve(BasicPuzzle<BOX>& p, const BenchOptions& options,
+          BasicDancingLinks<BOX>& dlx, long& pauses)
+{
+   if (options.limit > 0 && options.exactCover)
+      return dlx.countSolutions(p, options.limit);
+   if (options.exactCover)
+      return dlx.solve(p);
+   p.setMRV(options.mrv);
+   p.setPropagate(options.propagate);
+   p.setSimd(options.simd);
+   if (options.limit > 0)
+      return p.countSolutions(options.limit);
+   if (options.iterative)
+   {
+      typename BasicPuzzle<BOX>::Status status;
+      while ((status = p.search(options.budget)) ==
+             BasicPuzzle<BOX>::PAUSED)
+         pauses++;
+      return status == BasicPuzzle<BOX>::SOLVED;
+   }
+   if (options.searchThreads > 1)
+      return p.solveParallel(options.searchThreads);
+   return p.solve(0);
+}
+
+/**
+ * threadTime
+ * @return CPU time used by the calling thread, in seconds
+ */
+double threadTime()
+{
+   timespec now;
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+   return now.tv_sec + now.tv_nsec * 1e-9;
+}
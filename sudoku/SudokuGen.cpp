@@ -0,0 +1,192 @@
+/**
+ * SudokuGen.cpp
+ *
+ * Program to make Sudoku puzzles with the Generator class.
+ *
+ * Puzzles are printed one per line, in the format the batch solver reads
+ * (81 characters, 0 for an empty square), so they can be piped into
+ * sudoku -b or saved for sudoku_bench. Each has a unique solution, and
+ * no clue can be taken out without losing that. Puzzle n of a seed is
+ * the same on any number of threads. The time taken, the puzzles per
+ * second and the number of each grade are printed to stderr.
+ *
+ * Usage: sudoku_gen [-c count] [-t threads] [-s seed] [-g grade]
+ *                   [-n nodes] [-a] [-d size]
+ *   -c   number of puzzles (default 1)
+ *   -t   number of threads making puzzles (default 1)
+ *   -s   seed of the random puzzles (default 1)
+ *   -g   make only puzzles of this grade: easy (naked singles), medium
+ *        (naked and hidden singles), hard (up to 20 guesses with MRV
+ *        and propagation) or fiendish (more)
+ *   -n   most nodes of each search (default 100000); a clue whose
+ *        uniqueness check runs out is kept
+ *   -a   after each puzzle, print its grade, clues and guesses
+ *   -d   puzzles are size x size: 4, 9 (the default), 16 or 25
+ */
+
+#include "Generator.h"
+#include "WorkStealingPool.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Generator settings from the command line.
+ */
+struct GenOptions
+{
+   long count = 1; // puzzles to make
+   int threads = 1; // threads making puzzles
+   uint64_t seed = 1; // seed of the random puzzles
+   string grade = "any"; // grade to keep
+   long budget = 100000; // most nodes of each search
+   bool annotate = false; // print the grade, clues and guesses
+   int size = 9; // squares on a side: 4, 9, 16 or 25
+};
+
+// puzzles made and printed at a time
+const long GEN_PUZZLES = 1 << 12;
+
+/**
+ * run
+ * Make the puzzles on a board of BOX x BOX blocks, and print them.
+ * @param options generator settings
+ * @return exit status of the program
+ */
+template <int BOX>
+int run(const GenOptions& options);
+
+int main(int argc, const char * argv[])
+{
+   GenOptions options;
+   bool ok = true;
+
+   for (int i = 1; i < argc && ok; i++)
+   {
+      string arg = argv[i];
+      if (arg == "-c" && i + 1 < argc && atol(argv[i + 1]) > 0)
+         options.count = atol(argv[++i]);
+      else if (arg == "-t" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+         options.threads = atoi(argv[++i]);
+      else if (arg == "-s" && i + 1 < argc)
+         options.seed = strtoull(argv[++i], nullptr, 10);
+      else if (arg == "-g" && i + 1 < argc)
+         options.grade = argv[++i];
+      else if (arg == "-n" && i + 1 < argc && atol(argv[i + 1]) > 0)
+         options.budget = atol(argv[++i]);
+      else if (arg == "-a")
+         options.annotate = true;
+      else if (arg == "-d" && i + 1 < argc)
+         options.size = atoi(argv[++i]);
+      else
+         ok = false;
+   }
+   ok = ok && Generator::gradeOf(options.grade) != Generator::GRADES;
+
+   if (ok)
+   {
+      switch (options.size)
+      {
+      case 4:
+         return run<2>(options);
+      case 9:
+         return run<3>(options);
+      case 16:
+         return run<4>(options);
+      case 25:
+         return run<5>(options);
+      }
+   }
+   cout << "Usage: sudoku_gen [-c count] [-t threads] [-s seed] ";
+   cout << "[-g grade]" << endl;
+   cout << "                  [-n nodes] [-a] [-d size]" << endl;
+   cout << "grades: easy, medium, hard, fiendish" << endl;
+   return 1;
+}
+
+/**
+ * run
+ * Make the puzzles on a board of BOX x BOX blocks, GEN_PUZZLES at a time
+ * on a WorkStealingPool, and print them in order. A puzzle of the wanted
+ * grade that was not found is left out.
+ * @param options generator settings
+ * @return exit status of the program: 1 if a puzzle was left out
+ */
+template <int BOX>
+int run(const GenOptions& options)
+{
+   typedef BasicGenerator<BOX> Generator;
+   typedef typename Generator::Generated Generated;
+
+   Generator generator(options.seed);
+   generator.setGrade(Generator::gradeOf(options.grade));
+   generator.setBudget(options.budget);
+
+   ios::sync_with_stdio(false);
+   WorkStealingPool pool(options.threads);
+   vector<Generated> puzzles;
+   vector<char> made;
+   long grades[Generator::GRADES] = {};
+   long clues = 0;
+   long missing = 0;
+
+   auto start = chrono::steady_clock::now();
+   for (long first = 0; first < options.count; first += GEN_PUZZLES)
+   {
+      long n = min(GEN_PUZZLES, options.count - first);
+      puzzles.assign(n, Generated());
+      made.assign(n, 0);
+      pool.run(n, [&](size_t i, int) {
+         made[i] = generator.generate(first + i, puzzles[i]);
+      });
+
+      for (long i = 0; i < n; i++)
+      {
+         if (!made[i])
+         {
+            missing++;
+            continue;
+         }
+         const Generated& g = puzzles[i];
+         cout << g.puzzle;
+         if (options.annotate)
+         {
+            cout << ' ' << Generator::gradeName(g.grade) << ' ' << g.clues;
+            cout << ' ' << g.guesses;
+         }
+         cout << '\n';
+         grades[g.grade]++;
+         clues += g.clues;
+      }
+   }
+   cout.flush();
+   chrono::duration<double> time = chrono::steady_clock::now() - start;
+
+   long count = options.count - missing;
+   // the rate is formatted apart, so cerr keeps its default format
+   ostringstream rate;
+   rate << fixed << setprecision(1) << count / time.count();
+   cerr << "made " << count << " puzzles in " << time.count() << " s (";
+   cerr << rate.str() << " puzzles/s)";
+   if (count > 0)
+      cerr << ", " << (double) clues / count << " clues on average";
+   cerr << endl;
+   for (int g = 0; g < Generator::GRADES; g++)
+   {
+      cerr << (g == 0 ? "" : ", ") << Generator::gradeName(
+                 (typename Generator::Grade) g) << ' ' << grades[g];
+   }
+   cerr << endl;
+   if (missing > 0)
+   {
+      cerr << missing << " not " << options.grade << " after ";
+      cerr << "the most tries" << endl;
+   }
+   return missing > 0 ? 1 : 0;
+}
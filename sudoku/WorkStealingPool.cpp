@@ -0,0 +1,170 @@
+/**
+ * WorkStealingPool.cpp
+ * Definitions for class WorkStealingPool.
+ */
+
+#include "WorkStealingPool.h"
+
+/**
+ * Constructor.
+ * Start the worker threads.
+ * @param nThreads number of worker threads, at least 1
+ */
+WorkStealingPool::WorkStealingPool(int nThreads)
+{
+   if (nThreads < 1)
+      nThreads = 1;
+   for (int t = 0; t < nThreads; t++)
+      ranges.push_back(std::unique_ptr<Range>(new Range()));
+   for (int t = 0; t < nThreads; t++)
+      workers.push_back(std::thread(&WorkStealingPool::work, this, t));
+}
+
+/**
+ * destructor
+ * Stop and join the worker threads.
+ */
+WorkStealingPool::~WorkStealingPool()
+{
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      stopping = true;
+   }
+   started.notify_all();
+   for (size_t t = 0; t < workers.size(); t++)
+      workers[t].join();
+}
+
+/**
+ * run
+ * Run task(i, worker) for every i in [0, count), and wait until all
+ * are done. Worker t starts with the t-th of size() equal ranges.
+ * @param count number of tasks
+ * @param task task callback
+ */
+void WorkStealingPool::run(size_t count, const Task& task)
+{
+   size_t n = ranges.size();
+   for (size_t t = 0; t < n; t++)
+   {
+      std::lock_guard<std::mutex> guard(ranges[t]->lock);
+      ranges[t]->begin = count * t / n;
+      ranges[t]->end = count * (t + 1) / n;
+   }
+
+   std::unique_lock<std::mutex> guard(lock);
+   this->task = &task;
+   busy = (int) n;
+   generation++;
+   started.notify_all();
+   finished.wait(guard, [this]() { return busy == 0; });
+   this->task = nullptr;
+}
+
+/**
+ * work
+ * Worker thread: wait for each run, and take part in it until no range
+ * has a task left.
+ * @param worker number of this worker
+ */
+void WorkStealingPool::work(int worker)
+{
+   long seen = 0; // last run taken part in
+   while (true)
+   {
+      const Task* current;
+      {
+         std::unique_lock<std::mutex> guard(lock);
+         started.wait(guard, [&]() {
+                         return generation != seen || stopping; });
+         if (stopping)
+            return;
+         seen = generation;
+         current = task;
+      }
+
+      size_t i;
+      while (true)
+      {
+         if (next(worker, i))
+            (*current)(i, worker);
+         else if (!stealing || !steal(worker))
+            break;
+      }
+
+      std::lock_guard<std::mutex> guard(lock);
+      if (--busy == 0)
+         finished.notify_one();
+   }
+}
+
+/**
+ * next
+ * Take the next task of a worker's own range.
+ * @param worker number of the worker
+ * @param i set to the task number
+ * @return false if the range is empty, otherwise true
+ */
+bool WorkStealingPool::next(int worker, size_t& i)
+{
+   Range& own = *ranges[worker];
+   std::lock_guard<std::mutex> guard(own.lock);
+   if (own.begin == own.end)
+      return false;
+   i = own.begin++;
+   return true;
+}
+
+/**
+ * steal
+ * Move the back half of the largest other range into a worker's own
+ * (empty) range. Sizes are read one lock at a time, so the victim is
+ * checked again under its lock; a steal that loses a race retries.
+ * @param worker number of the thief
+ * @return false if every range was empty, otherwise true
+ */
+bool WorkStealingPool::steal(int worker)
+{
+   int n = (int) ranges.size();
+   while (true)
+   {
+      // find the largest range left
+      int victim = -1;
+      size_t largest = 0;
+      for (int k = 1; k < n; k++)
+      {
+         int t = (worker + k) % n;
+         std::lock_guard<std::mutex> guard(ranges[t]->lock);
+         size_t left = ranges[t]->end - ranges[t]->begin;
+         if (left > largest)
+         {
+            largest = left;
+            victim = t;
+         }
+      }
+      if (victim < 0)
+         return false;
+
+      size_t begin, end;
+      {
+         Range& other = *ranges[victim];
+         std::lock_guard<std::mutex> guard(other.lock);
+         if (other.begin == other.end)
+            continue;
+         // the back half, rounded up, so a last task can be stolen
+         begin = other.end - (other.end - other.begin + 1) / 2;
+         end = other.end;
+         other.end = begin;
+      }
+
+      {
+         Range& own = *ranges[worker];
+         std::lock_guard<std::mutex> guard(own.lock);
+         own.begin = begin;
+         own.end = end;
+      }
+      std::lock_guard<std::mutex> guard(lock);
+      steals++;
+      return true;
+   }
+}
@@ -0,0 +1,128 @@
+/**
+ * WorkStealingPool.h
+ * Declarations for class WorkStealingPool.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * class WorkStealingPool
+ * A fixed set of worker threads that run a numbered list of tasks.
+ * Each run splits the task numbers into one contiguous range per worker.
+ * A worker takes tasks from the front of its own range; when it is
+ * empty, it steals the back half of the largest range left, so one slow
+ * task holds up only the worker running it. Each range has its own lock,
+ * and a worker never holds two locks at once.
+ * With stealing turned off, each worker runs only its own range (static
+ * partitioning), for comparison.
+ */
+class WorkStealingPool
+{
+public:
+   /**
+    * Task callback: run task i on a worker.
+    * @param i task number
+    * @param worker number of the worker thread, 0 .. size() - 1, so a
+    *   task can use per-worker state without locking
+    */
+   typedef std::function<void(size_t i, int worker)> Task;
+
+   /**
+    * Constructor.
+    * Start the worker threads.
+    * @param nThreads number of worker threads, at least 1
+    */
+   explicit WorkStealingPool(int nThreads);
+
+   /**
+    * destructor
+    * Stop and join the worker threads.
+    */
+   ~WorkStealingPool();
+
+   /**
+    * run
+    * Run task(i, worker) for every i in [0, count), and wait until all
+    * are done. Not reentrant: call from one thread at a time.
+    * @param count number of tasks
+    * @param task task callback
+    */
+   void run(size_t count, const Task& task);
+
+   /**
+    * setStealing
+    * Turn work stealing on (the default) or off.
+    * @param stealing false: each worker runs only its own range
+    */
+   void setStealing(bool stealing) { this->stealing = stealing; }
+
+   /**
+    * getSteals
+    * Get the number of ranges stolen since the pool was created.
+    * @return number of steals
+    */
+   long getSteals() const { return this->steals; }
+
+   /**
+    * size
+    * @return number of worker threads
+    */
+   int size() const { return (int) this->workers.size(); }
+
+private:
+   /**
+    * The task numbers [begin, end) a worker has left.
+    */
+   struct Range
+   {
+      std::mutex lock;
+      size_t begin = 0;
+      size_t end = 0;
+   };
+
+   std::vector<std::thread> workers;
+   std::vector<std::unique_ptr<Range>> ranges; // one for each worker
+   bool stealing = true;
+   long steals = 0; // guarded by lock
+
+   std::mutex lock; // guards the fields below
+   std::condition_variable started; // signalled when a run begins
+   std::condition_variable finished; // signalled when a worker is idle
+   const Task* task = nullptr; // task of the current run
+   long generation = 0; // number of runs started
+   int busy = 0; // workers still running the current run
+   bool stopping = false; // destructor called
+
+   /**
+    * work
+    * Worker thread: wait for each run, and take part in it.
+    * @param worker number of this worker
+    */
+   void work(int worker);
+
+   /**
+    * next
+    * Take the next task of a worker's own range.
+    * @param worker number of the worker
+    * @param i set to the task number
+    * @return false if the range is empty, otherwise true
+    */
+   bool next(int worker, size_t& i);
+
+   /**
+    * steal
+    * Move the back half of the largest other range into a worker's own
+    * (empty) range.
+    * @param worker number of the thief
+    * @return false if every range was empty, otherwise true
+    */
+   bool steal(int worker);
+};